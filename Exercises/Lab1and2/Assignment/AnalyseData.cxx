@@ -6,11 +6,20 @@
 // This program reads (x,y) coordinate data from a file and performs various
 // analyses including printing data, calculating magnitudes, fitting curves,
 // and computing power functions.
+//
+// Run without arguments for the interactive menu, with --batch to process
+// many files non-interactively (see BatchMode.h), or with --follow to keep
+// analysing a file that is still being written (see FollowMode.h).
 
 #include "CustomFunctions.h"
+#include "AnalysisSession.h"
+#include "AsyncOutput.h"
+#include "BatchMode.h"
+#include "FollowMode.h"
 #include <iostream>
 #include <vector>
 #include <string>
+#include <algorithm>
 
 // Display menu options to user
 void displayMenu() {
@@ -27,14 +36,40 @@ void displayMenu() {
     std::cout << "Enter your choice (1-5): ";
 }
 
-int main() {
+// Print completion messages from the background writer
+void reportFinishedWrites(AsyncOutput& output) {
+    for (const std::string& message : output.takeCompleted()) {
+        std::cout << message << std::endl;
+    }
+}
+
+// Copy of the first n points, so a background write owns its own data
+Points2D firstPoints(const Points2D& data, int n) {
+    Points2D subset;
+    size_t count = std::min(static_cast<size_t>(std::max(n, 0)), data.size());
+    subset.reserve(count);
+    for (size_t i = 0; i < count; i++) {
+        subset.push_back(data.x(i), data.y(i));
+    }
+    return subset;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        if (std::string(argv[1]) == "--follow") return followMain(argc, argv);
+        return batchMain(argc, argv);
+    }
+
     // File paths - relative to current directory
     std::string dataFile = "../input2D_float.txt";
     std::string errorFile = "../error2D_float.txt";
 
-    // Read the data files at startup
+    // The session reads each file once and keeps results between menu actions
+    AnalysisSession session(dataFile, errorFile);
+
+    // Read the data file at startup
     std::cout << "Loading data from file..." << std::endl;
-    std::vector<std::pair<double, double>> data = readDataFile(dataFile);
+    const Points2D& data = session.data();
 
     if (data.empty()) {
         std::cerr << "Error: No data loaded. Please check the file path." << std::endl;
@@ -43,10 +78,15 @@ int main() {
 
     std::cout << "Successfully loaded " << data.size() << " data points!" << std::endl;
 
+    // Result files are written on a background thread so the menu comes back
+    // straight away; finished writes are reported before the menu is redrawn
+    AsyncOutput output;
+
     // Main program loop
     bool running = true;
 
     while (running) {
+        reportFinishedWrites(output);
         displayMenu();
 
         int choice;
@@ -67,11 +107,16 @@ int main() {
                 int N;
                 std::cin >> N;
 
-                printToTerminal(data, N);
+                printToTerminal(session.data(), N);
 
-                // Save to file
+                // Save to file in the background. Only the points that will be written
+                // are copied; N larger than the data still gives the 5-line fallback.
                 std::string filename = "output_first_N_lines.txt";
-                saveToFile(data, N, filename);
+                int count = (N > static_cast<int>(session.data().size())) ? 5 : N;
+                Points2D points = firstPoints(session.data(), count);
+                output.submit(filename, [points = std::move(points), N, filename](std::ostream& log) {
+                    return saveToFile(points, N, filename, 6, log);
+                });
 
                 break;
             }
@@ -79,13 +124,16 @@ int main() {
             case 2: {
                 // Calculate and display magnitudes
                 std::cout << "\nCalculating magnitudes..." << std::endl;
-                std::vector<double> magnitudes = calculateMagnitudes(data);
+                const std::vector<double>& magnitudes = session.magnitudes();
 
                 printToTerminal(magnitudes, "Magnitude of each data point");
 
-                // Save to file
+                // Save to file in the background
                 std::string filename = "output_magnitudes.txt";
-                saveToFile(magnitudes, filename, "Magnitude of each data point");
+                std::vector<double> values = magnitudes;
+                output.submit(filename, [values = std::move(values), filename](std::ostream& log) {
+                    return saveToFile(values, filename, "Magnitude of each data point", 8, log);
+                });
 
                 break;
             }
@@ -94,21 +142,17 @@ int main() {
                 // Fit straight line with chi-squared analysis
                 std::cout << "\nFitting straight line to data..." << std::endl;
 
-                // Need to load error data for chi-squared calculation
-                std::vector<std::pair<double, double>> errors = readErrorFile(errorFile);
-
-                if (errors.size() != data.size()) {
-                    std::cerr << "Error: Mismatch between data and error file sizes." << std::endl;
-                    break;
-                }
-
-                std::pair<std::pair<double, double>, double> fitResult = fitStraightLine(data, errors);
+                // Error data for the chi-squared calculation is loaded on first use
+                const std::pair<std::pair<double, double>, double>* fitResult = session.fitResult();
+                if (fitResult == nullptr) break;
 
-                printToTerminal(fitResult);
+                printToTerminal(*fitResult);
 
-                // Save to file
+                // Save to file in the background
                 std::string filename = "output_fit_results.txt";
-                saveToFile(fitResult, filename);
+                output.submit(filename, [result = *fitResult, filename](std::ostream& log) {
+                    return saveToFile(result, filename, 6, log);
+                });
 
                 break;
             }
@@ -117,25 +161,27 @@ int main() {
                 // Calculate x^y for each data point
                 std::cout << "\nCalculating x^y for each data point (recursively)..." << std::endl;
 
-                std::vector<double> powerResults;
-                for (const auto& point : data) {
-                    double x = point.first;
-                    double y = point.second;
-                    double result = powerRecursive(x, y);
-                    powerResults.push_back(result);
-                }
+                const std::vector<double>& powerResults = session.powerResults();
 
                 printToTerminal(powerResults, "Power calculation results (x^y with y rounded)");
 
-                // Save to file
+                // Save to file in the background
                 std::string filename = "output_power_results.txt";
-                saveToFile(powerResults, filename, "Power calculation results (x^y with y rounded)");
+                std::vector<double> values = powerResults;
+                output.submit(filename, [values = std::move(values), filename](std::ostream& log) {
+                    return saveToFile(values, filename, "Power calculation results (x^y with y rounded)", 8, log);
+                });
 
                 break;
             }
 
             case 5: {
-                // Exit program
+                // Exit program, making sure every queued write reaches disk first
+                if (output.pending() > 0) {
+                    std::cout << "\nWaiting for " << output.pending() << " file(s) to finish writing..." << std::endl;
+                }
+                output.drain();
+                reportFinishedWrites(output);
                 std::cout << "\nExiting program. Goodbye!" << std::endl;
                 running = false;
                 break;
@@ -0,0 +1,90 @@
+// AnalysisSession.cxx
+// Implementation of the cached analysis session
+// Date: October 2026
+
+#include "AnalysisSession.h"
+#include "CustomFunctions.h"
+#include <iostream>
+
+AnalysisSession::AnalysisSession(const std::string& dataFile, const std::string& errorFile) {
+    m_data.path = dataFile;
+    m_errors.path = errorFile;
+}
+
+bool AnalysisSession::refresh(Input& input) {
+    // Only a stat: no file contents are read unless the mtime has moved
+    std::error_code ec;
+    auto mtime = std::filesystem::last_write_time(input.path, ec);
+
+    if (input.loaded && (ec || mtime == input.mtime)) return false;
+    if (input.loaded) {
+        std::cout << input.path << " has changed on disk, reloading" << std::endl;
+    }
+
+    input.points = readDataFile(input.path);
+    input.mtime = mtime;
+    input.loaded = true;
+    return true;
+}
+
+// Anything derived from the data must be recomputed when it changes
+void AnalysisSession::refreshData() {
+    if (refresh(m_data)) {
+        m_magnitudes.reset();
+        m_powerResults.reset();
+        m_fitResult.reset();
+    }
+}
+
+void AnalysisSession::refreshErrors() {
+    if (refresh(m_errors)) {
+        m_fitResult.reset();
+    }
+}
+
+const Points2D& AnalysisSession::data() {
+    refreshData();
+    return m_data.points;
+}
+
+const Points2D& AnalysisSession::errors() {
+    refreshErrors();
+    return m_errors.points;
+}
+
+const std::vector<double>& AnalysisSession::magnitudes() {
+    refreshData();
+    if (!m_magnitudes) {
+        m_magnitudes = calculateMagnitudes(m_data.points);
+    }
+    return *m_magnitudes;
+}
+
+const std::vector<double>& AnalysisSession::powerResults() {
+    refreshData();
+    if (!m_powerResults) {
+        const Points2D& points = m_data.points;
+        std::vector<double> results(points.size());
+        for (size_t i = 0; i < points.size(); i++) {
+            results[i] = powerRecursive(points.x(i), points.y(i));
+        }
+        m_powerResults = std::move(results);
+    }
+    return *m_powerResults;
+}
+
+const std::pair<std::pair<double, double>, double>* AnalysisSession::fitResult() {
+    refreshData();
+    refreshErrors();
+
+    if (m_errors.points.size() != m_data.points.size()) {
+        std::cerr << "Error: Mismatch between data and error file sizes." << std::endl;
+        return nullptr;
+    }
+
+    if (!m_fitResult) {
+        // Use every core; the result is the same whatever the thread count
+        m_fitResult = fitStraightLine(m_data.points, m_errors.points, 0);
+    }
+    return &*m_fitResult;
+}
@@ -0,0 +1,56 @@
+// AnalysisSession.h
+// Keeps the input data and derived results in memory between menu actions
+// Date: October 2026
+
+#ifndef ANALYSISSESSION_H
+#define ANALYSISSESSION_H
+
+#include "Points2D.h"
+#include <string>
+#include <vector>
+#include <utility>
+#include <optional>
+#include <filesystem>
+
+// Owns the data and error columns for an interactive session. Each input is
+// read the first time it is needed and then reused; derived results
+// (magnitudes, fit, powers) are computed once and cached. Everything that
+// depends on an input is thrown away and recomputed only when that file's
+// modification time changes, so repeated operations do no file reads.
+class AnalysisSession {
+public:
+    AnalysisSession(const std::string& dataFile, const std::string& errorFile);
+
+    const Points2D& data();
+    const Points2D& errors();
+
+    const std::vector<double>& magnitudes();
+    const std::vector<double>& powerResults();
+
+    // Returns nullptr if the data and error files have different lengths
+    const std::pair<std::pair<double, double>, double>* fitResult();
+
+private:
+    // One input file and the mtime it had when it was read
+    struct Input {
+        std::string path;
+        Points2D points;
+        std::filesystem::file_time_type mtime;
+        bool loaded = false;
+    };
+
+    Input m_data;
+    Input m_errors;
+
+    std::optional<std::vector<double>> m_magnitudes;
+    std::optional<std::vector<double>> m_powerResults;
+    std::optional<std::pair<std::pair<double, double>, double>> m_fitResult;
+
+    // Read the input if it has never been read or has changed on disk.
+    // Returns true if it was (re)loaded.
+    bool refresh(Input& input);
+    void refreshData();
+    void refreshErrors();
+};
+
+#endif
@@ -0,0 +1,272 @@
+// BatchFit.cxx
+// Implementation of the batched series fits
+// Date: October 2026
+//
+// Each series is summed relative to its own first point, as in FitKernels,
+// and p and q follow from those sums directly. Chi-squared is then summed
+// from the residuals in a second pass over the series, which is short and
+// still in cache; expanding it in the sums cancels badly for precise data.
+// The AVX2 kernel keeps one series per lane; a lane whose series has ended is
+// masked off until the longest of the four is done.
+
+#include "BatchFit.h"
+#include "FitKernels.h"
+#include <immintrin.h>
+#include <iostream>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Sums of dx = x - x0, dy = y - y0 for one series
+struct SeriesSums {
+    double dx = 0.0, dy = 0.0, dxx = 0.0, dxy = 0.0;
+};
+
+// Slope, intercept and chi2/NDOF of series i from its sums and points.
+// Everything is worked out in the shifted coordinates and only the intercept
+// is moved back. The residuals are taken about the means, as in the AVX2
+// kernel.
+void finishSeries(const SeriesSums& s, const double* x, const double* y, const double* sigma,
+                  std::size_t n, SeriesFitTable& table, std::size_t i) {
+    if (n < 2) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        table.slope[i] = table.intercept[i] = table.chi2PerNdof[i] = nan;
+        return;
+    }
+    double x0 = x[0], y0 = y[0];
+    double count = static_cast<double>(n);
+    double mdx = s.dx / count, mdy = s.dy / count;
+    double cxx = s.dxx - s.dx * mdx;
+    double cxy = s.dxy - s.dx * mdy;
+    double p = cxy / cxx;
+    double shiftedIntercept = mdy - p * mdx;
+
+    double chi2 = 0.0;
+    for (std::size_t k = 0; k < n; k++) {
+        double r = ((y[k] - y0) - mdy) - p * ((x[k] - x0) - mdx);
+        double pull = r * (1.0 / sigma[k]);
+        chi2 += pull * pull;
+    }
+
+    table.slope[i] = p;
+    table.intercept[i] = y0 + shiftedIntercept - p * x0;
+    table.chi2PerNdof[i] = chi2 / (count - 2.0);
+}
+
+// ---------- Scalar ----------
+
+void fitOneScalar(const SeriesCollection& series, std::size_t i, SeriesFitTable& table) {
+    std::size_t start = series.offsets[i], n = series.length(i);
+    const double* x = series.x.data() + start;
+    const double* y = series.y.data() + start;
+    const double* sigma = series.sigma.data() + start;
+    double x0 = n > 0 ? x[0] : 0.0, y0 = n > 0 ? y[0] : 0.0;
+
+    SeriesSums s;
+    for (std::size_t k = 0; k < n; k++) {
+        double dx = x[k] - x0, dy = y[k] - y0;
+        s.dx += dx;
+        s.dy += dy;
+        s.dxx += dx * dx;
+        s.dxy += dx * dy;
+    }
+    finishSeries(s, x, y, sigma, n, table, i);
+}
+
+void fitScalar(const SeriesCollection& series, SeriesFitTable& table) {
+    for (std::size_t i = 0; i < series.size(); i++) fitOneScalar(series, i, table);
+}
+
+// ---------- AVX2 + FMA ----------
+
+// Turn rows r[j] = points k..k+3 of series j into columns r[t] = point k+t
+// of series 0..3
+__attribute__((target("avx2,fma")))
+void transpose(__m256d r[4]) {
+    __m256d t0 = _mm256_unpacklo_pd(r[0], r[1]);
+    __m256d t1 = _mm256_unpackhi_pd(r[0], r[1]);
+    __m256d t2 = _mm256_unpacklo_pd(r[2], r[3]);
+    __m256d t3 = _mm256_unpackhi_pd(r[2], r[3]);
+    r[0] = _mm256_permute2f128_pd(t0, t2, 0x20);
+    r[1] = _mm256_permute2f128_pd(t1, t3, 0x20);
+    r[2] = _mm256_permute2f128_pd(t0, t2, 0x31);
+    r[3] = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+// Points per lane that fitAVX2 keeps on the stack between its two passes
+// (a multiple of 4)
+const std::size_t bufferPoints = 32;
+
+// All-ones in the lanes whose series has a point k
+__attribute__((target("avx2,fma")))
+__m256d activeLanes(__m256i lengths, std::size_t k) {
+    __m256i index = _mm256_set1_epi64x(static_cast<long long>(k));
+    return _mm256_castsi256_pd(_mm256_cmpgt_epi64(lengths, index));
+}
+
+// Fits series in groups of four, one per lane. Each series is read four
+// contiguous points at a time and transposed in registers, which is much
+// cheaper than gathering one point per lane. The reads run up to three
+// points past a short series (masked off); a group whose reads would pass
+// the end of the columns is fitted by the scalar code instead.
+__attribute__((target("avx2,fma")))
+void fitAVX2(const SeriesCollection& series, SeriesFitTable& table) {
+    const std::size_t nSeries = series.size();
+    const std::size_t total = series.x.size();
+    const double* columns[3] = {series.x.data(), series.y.data(), series.sigma.data()};
+    const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+    const __m256d nan = _mm256_set1_pd(std::numeric_limits<double>::quiet_NaN());
+
+    std::size_t i = 0;
+    for (; i + 4 <= nSeries; i += 4) {
+        std::size_t start[4], length[4];
+        for (int j = 0; j < 4; j++) {
+            start[j] = series.offsets[i + j];
+            length[j] = series.length(i + j);
+        }
+        std::size_t longest = std::max(std::max(length[0], length[1]), std::max(length[2], length[3]));
+        std::size_t padded = (longest + 3) & ~static_cast<std::size_t>(3);
+        if (start[0] + padded > total || start[1] + padded > total ||
+            start[2] + padded > total || start[3] + padded > total) {
+            for (int j = 0; j < 4; j++) fitOneScalar(series, i + j, table);
+            continue;
+        }
+
+        // Shift point: each lane's first point (zero for empty series)
+        alignas(32) double shiftX[4], shiftY[4];
+        for (int j = 0; j < 4; j++) {
+            shiftX[j] = length[j] > 0 ? columns[0][start[j]] : 0.0;
+            shiftY[j] = length[j] > 0 ? columns[1][start[j]] : 0.0;
+        }
+        const __m256d x0 = _mm256_load_pd(shiftX), y0 = _mm256_load_pd(shiftY);
+        const __m256i lengths = _mm256_set_epi64x(static_cast<long long>(length[3]), static_cast<long long>(length[2]),
+                                                  static_cast<long long>(length[1]), static_cast<long long>(length[0]));
+
+        // The first bufferPoints points of each lane are kept, transposed,
+        // for the residual pass, so typical series are only read once. 1/sigma
+        // is worked out here, where the division overlaps with the sums.
+        __m256d bufferX[bufferPoints], bufferY[bufferPoints], bufferInverseSigma[bufferPoints];
+
+        __m256d sdx = zero, sdy = zero, sdxx = zero, sdxy = zero;
+        for (std::size_t k = 0; k < longest; k += 4) {
+            __m256d vx[4], vy[4], vs[4];
+            for (int j = 0; j < 4; j++) {
+                vx[j] = _mm256_loadu_pd(columns[0] + start[j] + k);
+                vy[j] = _mm256_loadu_pd(columns[1] + start[j] + k);
+                vs[j] = _mm256_loadu_pd(columns[2] + start[j] + k);
+            }
+            transpose(vx);
+            transpose(vy);
+            transpose(vs);
+
+            for (int t = 0; t < 4; t++) {
+                // Lanes whose series has no point k + t contribute exactly zero
+                __m256d active = activeLanes(lengths, k + t);
+                __m256d dx = _mm256_and_pd(_mm256_sub_pd(vx[t], x0), active);
+                __m256d dy = _mm256_and_pd(_mm256_sub_pd(vy[t], y0), active);
+                if (k < bufferPoints) {
+                    bufferX[k + t] = dx;
+                    bufferY[k + t] = dy;
+                    bufferInverseSigma[k + t] = _mm256_and_pd(_mm256_div_pd(one, vs[t]), active);
+                }
+
+                sdx = _mm256_add_pd(sdx, dx);
+                sdy = _mm256_add_pd(sdy, dy);
+                sdxx = _mm256_fmadd_pd(dx, dx, sdxx);
+                sdxy = _mm256_fmadd_pd(dx, dy, sdxy);
+            }
+        }
+
+        // The same arithmetic as finishSeries, one series per lane. Doing it
+        // here rather than calling finishSeries for each lane keeps the loop
+        // free of calls into SSE code, whose AVX/SSE transitions measured
+        // slower than the sums themselves.
+        const __m256d count = _mm256_set_pd(static_cast<double>(length[3]), static_cast<double>(length[2]),
+                                            static_cast<double>(length[1]), static_cast<double>(length[0]));
+        __m256d mdx = _mm256_div_pd(sdx, count), mdy = _mm256_div_pd(sdy, count);
+        __m256d cxx = _mm256_fnmadd_pd(sdx, mdx, sdxx);
+        __m256d cxy = _mm256_fnmadd_pd(sdx, mdy, sdxy);
+        __m256d p = _mm256_div_pd(cxy, cxx);
+        __m256d shiftedIntercept = _mm256_fnmadd_pd(p, mdx, mdy);
+
+        // Second pass: chi-squared from the residuals about the means
+        __m256d chi2 = zero;
+        for (std::size_t k = 0; k < longest; k += 4) {
+            __m256d vx[4], vy[4], vs[4];
+            if (k < bufferPoints) {
+                for (int t = 0; t < 4; t++) {
+                    vx[t] = bufferX[k + t];
+                    vy[t] = bufferY[k + t];
+                    vs[t] = bufferInverseSigma[k + t];
+                }
+            } else {
+                for (int j = 0; j < 4; j++) {
+                    vx[j] = _mm256_loadu_pd(columns[0] + start[j] + k);
+                    vy[j] = _mm256_loadu_pd(columns[1] + start[j] + k);
+                    vs[j] = _mm256_loadu_pd(columns[2] + start[j] + k);
+                }
+                transpose(vx);
+                transpose(vy);
+                transpose(vs);
+                for (int t = 0; t < 4; t++) {
+                    __m256d active = activeLanes(lengths, k + t);
+                    vx[t] = _mm256_and_pd(_mm256_sub_pd(vx[t], x0), active);
+                    vy[t] = _mm256_and_pd(_mm256_sub_pd(vy[t], y0), active);
+                    vs[t] = _mm256_and_pd(_mm256_div_pd(one, vs[t]), active);
+                }
+            }
+
+            for (int t = 0; t < 4; t++) {
+                __m256d r = _mm256_fnmadd_pd(p, _mm256_sub_pd(vx[t], mdx), _mm256_sub_pd(vy[t], mdy));
+                __m256d pull = _mm256_mul_pd(r, vs[t]);
+                chi2 = _mm256_fmadd_pd(pull, pull, chi2);
+            }
+        }
+
+        // Series with fewer than 2 points get NaN
+        __m256d valid = _mm256_cmp_pd(count, _mm256_set1_pd(2.0), _CMP_GE_OQ);
+        __m256d intercept = _mm256_fnmadd_pd(p, x0, _mm256_add_pd(y0, shiftedIntercept));
+        __m256d chi2PerNdof = _mm256_div_pd(chi2, _mm256_sub_pd(count, _mm256_set1_pd(2.0)));
+        _mm256_storeu_pd(table.slope.data() + i, _mm256_blendv_pd(nan, p, valid));
+        _mm256_storeu_pd(table.intercept.data() + i, _mm256_blendv_pd(nan, intercept, valid));
+        _mm256_storeu_pd(table.chi2PerNdof.data() + i, _mm256_blendv_pd(nan, chi2PerNdof, valid));
+    }
+    for (; i < nSeries; i++) fitOneScalar(series, i, table);
+}
+
+} // namespace
+
+void SeriesCollection::addSeries(const double* xs, const double* ys, const double* sigmas, std::size_t n) {
+    x.insert(x.end(), xs, xs + n);
+    y.insert(y.end(), ys, ys + n);
+    if (sigmas) sigma.insert(sigma.end(), sigmas, sigmas + n);
+    else sigma.insert(sigma.end(), n, 1.0);
+    offsets.push_back(x.size());
+}
+
+void SeriesCollection::addSeries(const Points2D& data, const Points2D& errors) {
+    if (errors.size() != data.size()) {
+        std::cerr << "Error: Mismatch between data and error file sizes." << std::endl;
+        return;
+    }
+    addSeries(data.xData(), data.yData(), errors.yData(), data.size());
+}
+
+void SeriesCollection::clear() {
+    x.clear();
+    y.clear();
+    sigma.clear();
+    offsets.assign(1, 0);
+}
+
+SeriesFitTable fitSeriesBatch(const SeriesCollection& series) {
+    SeriesFitTable table;
+    table.slope.resize(series.size());
+    table.intercept.resize(series.size());
+    table.chi2PerNdof.resize(series.size());
+
+    if (activeFitKernel() != FitKernel::Scalar) fitAVX2(series, table);
+    else fitScalar(series, table);
+    return table;
+}
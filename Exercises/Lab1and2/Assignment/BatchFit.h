@@ -0,0 +1,55 @@
+// BatchFit.h
+// Straight-line fits to many small, independent series in one call
+// Date: October 2026
+//
+// Calling fitStraightLine once per series pays for building Points2D
+// objects and setting up the reduction every time. Here all series live in
+// one flat set of columns with an offsets array marking where each starts,
+// and a single call fits them all. The AVX2 kernel fits four series at once,
+// one per vector lane, and the results come back as a struct-of-arrays
+// table. A group of four takes as long as its longest series, so batches of
+// similar lengths work best.
+//
+//   SeriesCollection series;
+//   for (...) series.addSeries(x, y, sigma, n);
+//   SeriesFitTable fits = fitSeriesBatch(series);
+//   double p = fits.slope[i];
+
+#ifndef BATCHFIT_H
+#define BATCHFIT_H
+
+#include "Points2D.h"
+#include <vector>
+#include <cstddef>
+
+// Ragged collection of series: series i is points offsets[i] .. offsets[i+1]-1
+struct SeriesCollection {
+    AlignedVector x, y, sigma;
+    std::vector<std::size_t> offsets{0};
+
+    std::size_t size() const { return offsets.size() - 1; }
+    std::size_t length(std::size_t i) const { return offsets[i + 1] - offsets[i]; }
+
+    // Append one series. sigma may be nullptr (sigma = 1).
+    void addSeries(const double* xs, const double* ys, const double* sigmas, std::size_t n);
+
+    // Append data with the y column of errors as sigma, like fitStraightLine
+    void addSeries(const Points2D& data, const Points2D& errors);
+
+    void clear();
+};
+
+// One row per series: the same ((p, q), chi2/NDOF) as fitStraightLine.
+// Series with fewer than 2 points get NaN.
+struct SeriesFitTable {
+    AlignedVector slope;
+    AlignedVector intercept;
+    AlignedVector chi2PerNdof;
+
+    std::size_t size() const { return slope.size(); }
+};
+
+// Fit every series, with the kernel chosen by activeFitKernel() (AVX2 or scalar)
+SeriesFitTable fitSeriesBatch(const SeriesCollection& series);
+
+#endif
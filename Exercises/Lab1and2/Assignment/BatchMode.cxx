@@ -0,0 +1,353 @@
+// BatchMode.cxx
+// Implementation of the batch mode
+// Date: October 2026
+
+#include "BatchMode.h"
+#include "CustomFunctions.h"
+#include "ResultWriter.h"
+#include "LinearFit.h"
+#include "Bootstrap.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <future>
+#include <chrono>
+#include <cmath>
+#include <set>
+
+namespace {
+
+// Outcome of one job, reported by the main thread once it completes
+struct JobResult {
+    bool ok = false;
+    std::size_t points = 0;
+    std::string outputFile;
+    std::string message;
+};
+
+// JSON string with quotes and backslashes escaped
+std::string jsonString(const std::string& text) {
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') quoted += '\\';
+        if (static_cast<unsigned char>(c) < 0x20) {
+            quoted += ' ';
+            continue;
+        }
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+// JSON has no NaN or infinity, so write those as null
+void writeNumber(ResultWriter& out, double value) {
+    if (std::isfinite(value)) out.write(value);
+    else out.write("null");
+}
+
+void writeArray(ResultWriter& out, const std::vector<double>& values) {
+    out.write("[");
+    for (std::size_t i = 0; i < values.size(); i++) {
+        if (i > 0) out.write(",");
+        writeNumber(out, values[i]);
+    }
+    out.write("]");
+}
+
+JobResult runJob(const BatchJob& job, const std::string& outputFile, const BatchOptions& options) {
+    JobResult result;
+    result.outputFile = outputFile;
+
+    Points2D data = readDataFile(job.input, false);
+    if (data.empty()) {
+        result.message = "no data read from " + job.input;
+        return result;
+    }
+    result.points = data.size();
+
+    std::pair<std::pair<double, double>, double> fitResult;
+    LinearFitResult weightedResult;
+    BootstrapResult bootstrap;
+    if (job.fit || job.weightedFit || job.bootstrap) {
+        Points2D errors = readErrorFile(job.errors, false);
+        if (errors.size() != data.size()) {
+            result.message = "error file " + job.errors + " does not match " + job.input;
+            return result;
+        }
+        if (job.fit) fitResult = fitStraightLine(data, errors);
+        if (job.weightedFit) weightedResult = LinearFit::polynomial(options.degree).fit(data, errors);
+        // Jobs already run in parallel, so each bootstrap uses one thread
+        if (job.bootstrap) {
+            bootstrap = bootstrapLineFit(data, errors, options.replicas, 0.6827, options.seed, 1);
+            if (!bootstrap.valid) {
+                result.message = "bootstrap failed for " + job.input;
+                return result;
+            }
+        }
+    }
+
+    // Results are written at full precision so they can be read back exactly
+    ResultWriter out(outputFile);
+    if (!out.isOpen()) {
+        result.message = "could not create " + outputFile;
+        return result;
+    }
+    out.setPrecision(SHORTEST_ROUND_TRIP);
+
+    out.write("{\n  \"input\": ").write(jsonString(job.input));
+    out.write(",\n  \"points\": ").write(static_cast<long long>(data.size()));
+
+    if (job.print) {
+        std::size_t n = std::min(static_cast<std::size_t>(std::max(options.printLines, 0)), data.size());
+        out.write(",\n  \"print\": [");
+        for (std::size_t i = 0; i < n; i++) {
+            if (i > 0) out.write(",");
+            out.write("[");
+            writeNumber(out, data.x(i));
+            out.write(",");
+            writeNumber(out, data.y(i));
+            out.write("]");
+        }
+        out.write("]");
+    }
+    if (job.magnitudes) {
+        out.write(",\n  \"magnitudes\": ");
+        writeArray(out, calculateMagnitudes(data));
+    }
+    if (job.fit) {
+        out.write(",\n  \"fit\": {\"p\": ");
+        writeNumber(out, fitResult.first.first);
+        out.write(", \"q\": ");
+        writeNumber(out, fitResult.first.second);
+        out.write(", \"chi2_ndof\": ");
+        writeNumber(out, fitResult.second);
+        out.write("}");
+    }
+    if (job.weightedFit) {
+        out.write(",\n  \"wfit\": {\"basis\": [");
+        for (std::size_t i = 0; i < weightedResult.size(); i++) {
+            if (i > 0) out.write(",");
+            out.write(jsonString(weightedResult.names[i]));
+        }
+        out.write("], \"parameters\": ");
+        writeArray(out, weightedResult.parameters);
+        out.write(", \"covariance\": ");
+        writeArray(out, weightedResult.covariance);
+        out.write(", \"chi2_ndof\": ");
+        writeNumber(out, weightedResult.valid ? weightedResult.chi2PerNdof() : std::nan(""));
+        out.write("}");
+    }
+    if (job.bootstrap) {
+        auto writeInterval = [&](const char* name, const BootstrapInterval& interval) {
+            out.write("\"").write(name).write("\": {\"nominal\": ");
+            writeNumber(out, interval.nominal);
+            out.write(", \"std_dev\": ");
+            writeNumber(out, interval.stdDev);
+            out.write(", \"lower\": ");
+            writeNumber(out, interval.lower);
+            out.write(", \"upper\": ");
+            writeNumber(out, interval.upper);
+            out.write("}");
+        };
+        out.write(",\n  \"bootstrap\": {\"replicas\": ").write(static_cast<long long>(bootstrap.replicas));
+        out.write(", \"dropped\": ").write(static_cast<long long>(bootstrap.dropped));
+        out.write(", \"seed\": ").write(static_cast<long long>(bootstrap.seed));
+        out.write(", \"confidence\": ");
+        writeNumber(out, bootstrap.confidence);
+        out.write(", ");
+        writeInterval("p", bootstrap.slope);
+        out.write(", ");
+        writeInterval("q", bootstrap.intercept);
+        out.write("}");
+    }
+    if (job.power) {
+        std::vector<double> powers(data.size());
+        for (std::size_t i = 0; i < data.size(); i++) {
+            powers[i] = powerRecursive(data.x(i), data.y(i));
+        }
+        out.write(",\n  \"power\": ");
+        writeArray(out, powers);
+    }
+    out.write("\n}").newline();
+
+    if (!out.close()) {
+        result.message = "could not write " + outputFile;
+        return result;
+    }
+    result.ok = true;
+    return result;
+}
+
+void printUsage() {
+    std::cerr << "Usage:\n"
+              << "  AnalyseData                     interactive menu\n"
+              << "  AnalyseData --batch [options] INPUT...\n"
+              << "  AnalyseData --batch --jobs FILE [options]\n\n"
+              << "Options:\n"
+              << "  --ops LIST      comma-separated operations: print,magnitudes,fit,power,wfit,bootstrap\n"
+              << "                  (default: print,magnitudes,fit,power)\n"
+              << "  --errors FILE   error file used by \"fit\" for every INPUT\n"
+              << "  --jobs FILE     job file, one \"<input> <ops> [<errors>]\" per line\n"
+              << "  --threads N     worker threads (default: one per core)\n"
+              << "  --outdir DIR    where to write <input>.results.json (default: .)\n"
+              << "  --lines N       points written by \"print\" (default: 5)\n"
+              << "  --degree K      polynomial degree for \"wfit\" (default: 1)\n"
+              << "  --replicas B    bootstrap replicas (default: 1000)\n"
+              << "  --seed S        bootstrap random seed (default: 12345)\n";
+}
+
+} // namespace
+
+bool parseOperations(const std::string& list, BatchJob& job) {
+    std::stringstream ss(list);
+    std::string op;
+    while (std::getline(ss, op, ',')) {
+        if (op == "print") job.print = true;
+        else if (op == "magnitudes") job.magnitudes = true;
+        else if (op == "fit") job.fit = true;
+        else if (op == "power") job.power = true;
+        else if (op == "wfit") job.weightedFit = true;
+        else if (op == "bootstrap") job.bootstrap = true;
+        else if (op == "all") job.print = job.magnitudes = job.fit = job.power = true;
+        else {
+            std::cerr << "Error: Unknown operation '" << op << "'" << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool readJobFile(const std::string& filename, std::vector<BatchJob>& jobs) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Could not open job file " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        std::stringstream ss(line);
+        BatchJob job;
+        std::string ops;
+        if (!(ss >> job.input) || job.input[0] == '#') continue;
+        if (!(ss >> ops) || !parseOperations(ops, job)) {
+            std::cerr << "Error: Bad job on line " << lineNumber << " of " << filename << std::endl;
+            return false;
+        }
+        ss >> job.errors;
+        jobs.push_back(job);
+    }
+    return true;
+}
+
+int runBatch(const std::vector<BatchJob>& jobs, const BatchOptions& options) {
+    std::filesystem::create_directories(options.outputDir);
+
+    // Name outputs after the input stems, keeping them unique
+    std::vector<std::string> outputs;
+    std::set<std::string> used;
+    for (const auto& job : jobs) {
+        std::string stem = std::filesystem::path(job.input).stem().string();
+        std::string name = stem;
+        for (int copy = 2; used.count(name); copy++) name = stem + "_" + std::to_string(copy);
+        used.insert(name);
+        outputs.push_back((std::filesystem::path(options.outputDir) / (name + ".results.json")).string());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::future<JobResult>> futures;
+    ThreadPool pool(options.threads);
+    std::cout << "Running " << jobs.size() << " job(s) on " << pool.size() << " thread(s)" << std::endl;
+
+    for (std::size_t i = 0; i < jobs.size(); i++) {
+        const BatchJob* job = &jobs[i];
+        const std::string* output = &outputs[i];
+        futures.push_back(pool.submit([job, output, &options]() { return runJob(*job, *output, options); }));
+    }
+
+    // Report in submission order as results become available
+    int failures = 0;
+    std::size_t totalPoints = 0;
+    for (std::size_t i = 0; i < futures.size(); i++) {
+        JobResult result = futures[i].get();
+        if (result.ok) {
+            totalPoints += result.points;
+            std::cout << jobs[i].input << " -> " << result.outputFile << " (" << result.points << " points)" << std::endl;
+        } else {
+            failures++;
+            std::cerr << "Error: " << jobs[i].input << ": " << result.message << std::endl;
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double seconds = elapsed.count();
+    std::cout << "Processed " << jobs.size() - failures << "/" << jobs.size() << " files, "
+              << totalPoints << " points in " << seconds << " s ("
+              << (seconds > 0.0 ? (jobs.size() - failures) / seconds : 0.0) << " files/s, "
+              << (seconds > 0.0 ? totalPoints / seconds : 0.0) << " points/s)" << std::endl;
+    return failures;
+}
+
+int batchMain(int argc, char* argv[]) {
+    std::vector<BatchJob> jobs;
+    BatchOptions options;
+    BatchJob defaults;
+    std::string jobFile;
+    std::vector<std::string> inputs;
+    bool opsGiven = false;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--batch") continue;
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--ops" && hasValue) {
+            if (!parseOperations(argv[++i], defaults)) return 1;
+            opsGiven = true;
+        }
+        else if (arg == "--errors" && hasValue) defaults.errors = argv[++i];
+        else if (arg == "--jobs" && hasValue) jobFile = argv[++i];
+        else if (arg == "--threads" && hasValue) options.threads = std::atoi(argv[++i]);
+        else if (arg == "--outdir" && hasValue) options.outputDir = argv[++i];
+        else if (arg == "--lines" && hasValue) options.printLines = std::atoi(argv[++i]);
+        else if (arg == "--degree" && hasValue) options.degree = std::atoi(argv[++i]);
+        else if (arg == "--replicas" && hasValue) options.replicas = std::atoi(argv[++i]);
+        else if (arg == "--seed" && hasValue) options.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Error: Unknown or incomplete option " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        else inputs.push_back(arg);
+    }
+
+    if (!opsGiven) defaults.print = defaults.magnitudes = defaults.fit = defaults.power = true;
+
+    if (!jobFile.empty() && !readJobFile(jobFile, jobs)) return 1;
+    for (const auto& input : inputs) {
+        BatchJob job = defaults;
+        job.input = input;
+        jobs.push_back(job);
+    }
+
+    if (jobs.empty()) {
+        printUsage();
+        return 1;
+    }
+    for (const auto& job : jobs) {
+        if ((job.fit || job.weightedFit || job.bootstrap) && job.errors.empty()) {
+            std::cerr << "Error: A fit was requested for " << job.input << " without an error file" << std::endl;
+            return 1;
+        }
+    }
+
+    return runBatch(jobs, options) == 0 ? 0 : 1;
+}
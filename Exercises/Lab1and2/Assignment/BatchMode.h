@@ -0,0 +1,49 @@
+// BatchMode.h
+// Non-interactive batch processing for AnalyseData
+// Date: October 2026
+
+#ifndef BATCHMODE_H
+#define BATCHMODE_H
+
+#include <string>
+#include <vector>
+
+// Operations that can be requested for each input file
+struct BatchJob {
+    std::string input;
+    std::string errors;      // needed for "fit"
+    bool print = false;      // first N points
+    bool magnitudes = false;
+    bool fit = false;
+    bool power = false;
+    bool weightedFit = false; // "wfit": polynomial fit weighted by the errors
+    bool bootstrap = false;   // bootstrap uncertainties on p and q
+};
+
+// Settings shared by every job in a batch
+struct BatchOptions {
+    std::string outputDir = ".";
+    int threads = 0;         // <= 0 uses one per hardware core
+    int printLines = 5;      // N for the "print" operation
+    int degree = 1;          // polynomial degree for "wfit"
+    int replicas = 1000;     // bootstrap replicas
+    unsigned long long seed = 12345; // bootstrap seed
+};
+
+// Parse a comma-separated list such as "print,fit" into the job's flags.
+// Returns false (with a message) on an unknown operation.
+bool parseOperations(const std::string& list, BatchJob& job);
+
+// Read a job file: one job per line as
+//   <input> <operations> [<error file>]
+// Blank lines and lines starting with '#' are ignored.
+bool readJobFile(const std::string& filename, std::vector<BatchJob>& jobs);
+
+// Run every job on a worker pool, writing <outputDir>/<input stem>.results.json
+// for each input. Returns the number of jobs that failed.
+int runBatch(const std::vector<BatchJob>& jobs, const BatchOptions& options);
+
+// Entry point for `AnalyseData --batch ...`; returns the process exit code
+int batchMain(int argc, char* argv[]);
+
+#endif
@@ -0,0 +1,184 @@
+// BenchmarkFit.cxx
+// Times fitStraightLine with each fit kernel against the original two-pass fit
+// Date: October 2026
+//
+// Usage: ./BenchmarkFit [number of points] [repeats] [max threads] [number of series]
+
+#include "CustomFunctions.h"
+#include "FitKernels.h"
+#include "BatchFit.h"
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+// The fit as originally written: plain sums, then a second pass for chi-squared
+std::pair<std::pair<double, double>, double> originalFit(const Points2D& data, const Points2D& errors) {
+    int N = data.size();
+    double sum_x = 0.0, sum_y = 0.0, sum_xy = 0.0, sum_x2 = 0.0;
+    for (int i = 0; i < N; i++) {
+        double x = data.x(i);
+        double y = data.y(i);
+        sum_x += x;
+        sum_y += y;
+        sum_xy += x * y;
+        sum_x2 += x * x;
+    }
+    double p = (N * sum_xy - sum_x * sum_y) / (N * sum_x2 - sum_x * sum_x);
+    double q = (sum_x2 * sum_y - sum_xy * sum_x) / (N * sum_x2 - sum_x * sum_x);
+
+    double chi_squared = 0.0;
+    for (int i = 0; i < N; i++) {
+        double residual = (data.y(i) - (p * data.x(i) + q)) / errors.y(i);
+        chi_squared += residual * residual;
+    }
+    return std::make_pair(std::make_pair(p, q), chi_squared / (N - 2));
+}
+
+// Best wall time of repeats calls, in seconds
+template <typename Function>
+double bestTime(int repeats, Function function) {
+    double best = 1e300;
+    for (int r = 0; r < repeats; r++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count());
+    }
+    return best;
+}
+
+double relativeDifference(double a, double b) {
+    return std::abs(a - b) / std::max(std::abs(b), 1e-300);
+}
+
+int main(int argc, char* argv[]) {
+    long long n = (argc > 1) ? std::atoll(argv[1]) : 20000000;
+    int repeats = (argc > 2) ? std::atoi(argv[2]) : 3;
+    int maxThreads = (argc > 3) ? std::atoi(argv[3]) : static_cast<int>(std::thread::hardware_concurrency());
+    long long nSeries = (argc > 4) ? std::atoll(argv[4]) : 1000000;
+
+    std::cout << "Generating " << n << " points..." << std::endl;
+    Points2D data, errors;
+    data.resize(n);
+    errors.resize(n);
+    std::mt19937_64 rng(2026);
+    std::uniform_real_distribution<double> uniform(0.0, 5.0);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    for (long long i = 0; i < n; i++) {
+        double x = uniform(rng);
+        double sigma = 0.1 + 0.05 * uniform(rng);
+        data.xData()[i] = x;
+        data.yData()[i] = 0.5 * x + 2.0 + sigma * noise(rng);
+        errors.xData()[i] = 0.0;
+        errors.yData()[i] = sigma;
+    }
+
+    std::pair<std::pair<double, double>, double> reference;
+    double baseline = bestTime(repeats, [&]() { reference = originalFit(data, errors); });
+
+    FitKernel defaultKernel = activeFitKernel();
+    std::cout << "Default kernel on this CPU: " << fitKernelName(defaultKernel) << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\nKernel      time (s)   ns/point   speedup   max rel. diff" << std::endl;
+    std::cout << "original    " << std::setw(8) << baseline << "   " << std::setw(8) << baseline / n * 1e9
+              << "   " << std::setw(7) << 1.0 << "   -" << std::endl;
+
+    FitKernel best = detectFitKernel();
+    for (FitKernel kernel : {FitKernel::Scalar, FitKernel::AVX2, FitKernel::AVX512}) {
+        if (static_cast<int>(kernel) > static_cast<int>(best)) break;
+        setFitKernel(kernel);
+
+        std::pair<std::pair<double, double>, double> result;
+        double time = bestTime(repeats, [&]() { result = fitStraightLine(data, errors); });
+        double difference = std::max({relativeDifference(result.first.first, reference.first.first),
+                                      relativeDifference(result.first.second, reference.first.second),
+                                      relativeDifference(result.second, reference.second)});
+
+        std::cout << std::left << std::setw(12) << fitKernelName(kernel) << std::right
+                  << std::setw(8) << time << "   " << std::setw(8) << time / n * 1e9 << "   "
+                  << std::setw(7) << baseline / time << "   " << std::scientific << std::setprecision(1)
+                  << difference << std::fixed << std::setprecision(3) << std::endl;
+    }
+
+    // Parallel reduction with the default kernel: time against thread count,
+    // and check every result is bit-identical to the single-threaded one
+    setFitKernel(defaultKernel);
+    std::pair<std::pair<double, double>, double> serial = fitStraightLine(data, errors, 1);
+    double serialTime = 0.0;
+    std::cout << "\nThreads     time (s)   GB/s       speedup   bit-identical" << std::endl;
+    for (int threads = 1; threads <= std::max(maxThreads, 1); threads *= 2) {
+        std::pair<std::pair<double, double>, double> result;
+        double time = bestTime(repeats, [&]() { result = fitStraightLine(data, errors, threads); });
+        if (threads == 1) serialTime = time;
+        bool identical = std::memcmp(&result.first.first, &serial.first.first, sizeof(double)) == 0 &&
+                         std::memcmp(&result.first.second, &serial.first.second, sizeof(double)) == 0 &&
+                         std::memcmp(&result.second, &serial.second, sizeof(double)) == 0;
+
+        // x, y and sigma are each read once
+        double gigabytes = 3.0 * sizeof(double) * n / 1e9;
+        std::cout << std::left << std::setw(12) << threads << std::right << std::setw(8) << time << "   "
+                  << std::setw(8) << gigabytes / time << "   " << std::setw(7) << serialTime / time << "   "
+                  << (identical ? "yes" : "NO") << std::endl;
+    }
+
+    // Many small series: one fitStraightLine call per series against a
+    // single fitSeriesBatch call over all of them
+    std::cout << "\nGenerating " << nSeries << " series of 8 to 32 points..." << std::endl;
+    SeriesCollection series;
+    std::uniform_int_distribution<int> lengthDistribution(8, 32);
+    for (long long s = 0; s < nSeries; s++) {
+        int length = lengthDistribution(rng);
+        std::size_t start = static_cast<std::size_t>(rng() % static_cast<std::uint64_t>(n - length));
+        series.addSeries(data.xData() + start, data.yData() + start, errors.yData() + start, length);
+    }
+
+    SeriesFitTable separate;
+    separate.slope.resize(nSeries);
+    separate.intercept.resize(nSeries);
+    separate.chi2PerNdof.resize(nSeries);
+    double separateTime = bestTime(repeats, [&]() {
+        for (long long s = 0; s < nSeries; s++) {
+            Points2D seriesData, seriesErrors;
+            for (std::size_t k = series.offsets[s]; k < series.offsets[s + 1]; k++) {
+                seriesData.push_back(series.x[k], series.y[k]);
+                seriesErrors.push_back(0.0, series.sigma[k]);
+            }
+            std::pair<std::pair<double, double>, double> result = fitStraightLine(seriesData, seriesErrors);
+            separate.slope[s] = result.first.first;
+            separate.intercept[s] = result.first.second;
+            separate.chi2PerNdof[s] = result.second;
+        }
+    });
+
+    std::cout << "\nSeries fit  time (s)   series/s   speedup   max rel. diff" << std::endl;
+    std::cout << "separate    " << std::setw(8) << separateTime << "   " << std::scientific << std::setprecision(2)
+              << nSeries / separateTime << std::fixed << std::setprecision(3) << "   " << std::setw(7) << 1.0
+              << "   -" << std::endl;
+    for (FitKernel kernel : {FitKernel::Scalar, FitKernel::AVX2}) {
+        if (static_cast<int>(kernel) > static_cast<int>(best)) break;
+        setFitKernel(kernel);
+
+        SeriesFitTable batched;
+        double time = bestTime(repeats, [&]() { batched = fitSeriesBatch(series); });
+        double difference = 0.0;
+        for (long long s = 0; s < nSeries; s++) {
+            difference = std::max({difference, relativeDifference(batched.slope[s], separate.slope[s]),
+                                   relativeDifference(batched.intercept[s], separate.intercept[s]),
+                                   relativeDifference(batched.chi2PerNdof[s], separate.chi2PerNdof[s])});
+        }
+
+        std::cout << std::left << std::setw(12) << (std::string("batch ") + fitKernelName(kernel)) << std::right
+                  << std::setw(8) << time << "   " << std::scientific << std::setprecision(2) << nSeries / time
+                  << "   " << std::fixed << std::setprecision(3) << std::setw(7) << separateTime / time << "   "
+                  << std::scientific << std::setprecision(1) << difference << std::fixed << std::setprecision(3)
+                  << std::endl;
+    }
+    setFitKernel(defaultKernel);
+    return 0;
+}
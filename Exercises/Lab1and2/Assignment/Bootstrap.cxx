@@ -0,0 +1,157 @@
+// Bootstrap.cxx
+// Implementation of the bootstrap for the straight-line fit
+// Date: October 2026
+
+#include "Bootstrap.h"
+#include "LineFitAccumulator.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+namespace {
+
+// SplitMix64: small, fast and well mixed. Also used to derive the seed of
+// each replica's stream from the user seed and the replica number.
+class SplitMix64 {
+public:
+    explicit SplitMix64(std::uint64_t seed) : m_state(seed) {}
+
+    std::uint64_t next() {
+        std::uint64_t z = (m_state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform index in [0, n) by multiply-shift, with no modulo bias worth
+    // worrying about for n far below 2^64
+    std::size_t index(std::size_t n) {
+        return static_cast<std::size_t>((static_cast<unsigned __int128>(next()) * n) >> 64);
+    }
+
+private:
+    std::uint64_t m_state;
+};
+
+// Points drawn before each hand-off to the accumulator
+const std::size_t drawBlock = 512;
+
+// Fit one replica: draw N points with replacement into a small buffer and
+// feed it to the accumulator block by block
+std::pair<double, double> fitReplica(const Points2D& data, const Points2D& errors,
+                                     std::uint64_t seed, int replica) {
+    SplitMix64 seeder(seed ^ (0x5851f42d4c957f2dULL * static_cast<std::uint64_t>(replica + 1)));
+    SplitMix64 rng(seeder.next());
+
+    const std::size_t n = data.size();
+    double x[drawBlock], y[drawBlock], sigma[drawBlock];
+    LineFitAccumulator fit;
+
+    for (std::size_t done = 0; done < n; done += drawBlock) {
+        std::size_t m = std::min(drawBlock, n - done);
+        for (std::size_t i = 0; i < m; i++) {
+            std::size_t k = rng.index(n);
+            x[i] = data.x(k);
+            y[i] = data.y(k);
+            sigma[i] = errors.y(k);
+        }
+        fit.addBlock(x, y, sigma, m);
+    }
+    return {fit.slope(), fit.intercept()};
+}
+
+// Mean, spread and percentile interval of the replica values
+BootstrapInterval summarise(std::vector<double> values, double nominal, double confidence) {
+    BootstrapInterval interval;
+    interval.nominal = nominal;
+
+    double sum = 0.0;
+    for (double v : values) sum += v;
+    interval.mean = sum / values.size();
+
+    double squares = 0.0;
+    for (double v : values) squares += (v - interval.mean) * (v - interval.mean);
+    interval.stdDev = (values.size() > 1) ? std::sqrt(squares / (values.size() - 1)) : 0.0;
+
+    // Interpolated percentiles at (1 -/+ confidence) / 2
+    std::sort(values.begin(), values.end());
+    auto percentile = [&](double fraction) {
+        double position = fraction * (values.size() - 1);
+        std::size_t below = static_cast<std::size_t>(std::floor(position));
+        std::size_t above = std::min(below + 1, values.size() - 1);
+        return values[below] + (position - below) * (values[above] - values[below]);
+    };
+    interval.lower = percentile((1.0 - confidence) / 2.0);
+    interval.upper = percentile((1.0 + confidence) / 2.0);
+    return interval;
+}
+
+} // namespace
+
+BootstrapResult bootstrapLineFit(const Points2D& data, const Points2D& errors, int replicas,
+                                 double confidence, std::uint64_t seed, int nThreads) {
+    BootstrapResult result;
+    result.replicas = std::max(replicas, 0);
+    result.confidence = confidence;
+    result.seed = seed;
+
+    if (errors.size() != data.size() || data.size() < 3 || result.replicas == 0) {
+        std::cerr << "Error: Bootstrap needs matching data and error files with at least 3 points "
+                  << "and at least one replica." << std::endl;
+        return result;
+    }
+    // The percentiles (1 -/+ confidence) / 2 must lie inside the sorted replicas
+    if (!(confidence > 0.0 && confidence < 1.0)) {
+        std::cerr << "Error: Bootstrap confidence must be between 0 and 1 (exclusive), got " << confidence << "."
+                  << std::endl;
+        return result;
+    }
+
+    LineFitAccumulator nominal = accumulateLineFit(data.xData(), data.yData(), errors.yData(), data.size());
+
+    // Each task fits a contiguous range of replicas and writes them in place
+    result.slopes.resize(result.replicas);
+    result.intercepts.resize(result.replicas);
+    auto fitRange = [&](int first, int last) {
+        for (int r = first; r < last; r++) {
+            std::pair<double, double> fit = fitReplica(data, errors, seed, r);
+            result.slopes[r] = fit.first;
+            result.intercepts[r] = fit.second;
+        }
+    };
+
+    ThreadPool pool(nThreads);
+    int nTasks = std::min(result.replicas, pool.size() * 4);
+    std::vector<std::future<void>> tasks;
+    for (int t = 0; t < nTasks; t++) {
+        int first = static_cast<int>(static_cast<long long>(result.replicas) * t / nTasks);
+        int last = static_cast<int>(static_cast<long long>(result.replicas) * (t + 1) / nTasks);
+        tasks.push_back(pool.submit([&fitRange, first, last]() { fitRange(first, last); }));
+    }
+    for (auto& task : tasks) task.get();
+
+    // Leave out replicas with no finite fit, which would poison the mean and
+    // break the ordering std::sort needs for the percentiles
+    std::size_t kept = 0;
+    for (int r = 0; r < result.replicas; r++) {
+        if (!std::isfinite(result.slopes[r]) || !std::isfinite(result.intercepts[r])) continue;
+        result.slopes[kept] = result.slopes[r];
+        result.intercepts[kept] = result.intercepts[r];
+        kept++;
+    }
+    result.slopes.resize(kept);
+    result.intercepts.resize(kept);
+    result.dropped = result.replicas - static_cast<int>(kept);
+    if (kept < 2 || 2 * kept < static_cast<std::size_t>(result.replicas)) {
+        std::cerr << "Error: Only " << kept << " of " << result.replicas
+                  << " bootstrap replicas gave a finite fit (too few distinct x values?)." << std::endl;
+        return result;
+    }
+
+    result.slope = summarise(result.slopes, nominal.slope(), confidence);
+    result.intercept = summarise(result.intercepts, nominal.intercept(), confidence);
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,57 @@
+// Bootstrap.h
+// Bootstrap uncertainties for the straight-line fit
+// Date: October 2026
+//
+// Each replica draws N points with replacement from the N (x, y, sigma)
+// points and refits them with LineFitAccumulator, the same code used by
+// fitStraightLine. The spread of the replica fits gives the uncertainties
+// on p and q.
+//
+// Replicas run in parallel. Replica r always uses its own random stream,
+// derived from (seed, r), so the result doesn't depend on the thread count.
+// The resampled points are never stored as a whole: they are drawn into a
+// small fixed buffer that is fed to the accumulator a block at a time.
+//
+// A replica whose fit is not finite (e.g. every draw has the same x, so the
+// slope is 0/0) is left out of the intervals and counted in dropped. The
+// result is only valid if at least half of the replicas, and at least 2,
+// gave a finite fit.
+
+#ifndef BOOTSTRAP_H
+#define BOOTSTRAP_H
+
+#include "Points2D.h"
+#include <vector>
+#include <cstdint>
+
+// Summary of the bootstrap distribution of one parameter
+struct BootstrapInterval {
+    double nominal = 0.0;    // fit to the original points
+    double mean = 0.0;       // mean over replicas
+    double stdDev = 0.0;     // standard deviation over replicas
+    double lower = 0.0;      // percentile confidence interval
+    double upper = 0.0;
+};
+
+struct BootstrapResult {
+    bool valid = false;       // false if the bootstrap failed; the intervals are then unset
+    int replicas = 0;         // replicas requested
+    int dropped = 0;          // replicas left out because their fit was not finite
+    double confidence = 0.0;
+    std::uint64_t seed = 0;
+    BootstrapInterval slope;      // p
+    BootstrapInterval intercept;  // q
+
+    // Fitted p and q of every replica kept, in replica order
+    std::vector<double> slopes;
+    std::vector<double> intercepts;
+};
+
+// Bootstrap the fit of data with the y column of errors as sigma.
+// confidence is the central fraction covered by [lower, upper] (0.6827 is
+// one standard deviation for a Gaussian) and must be strictly between 0 and
+// 1, otherwise the result is not valid. nThreads <= 0 uses every core.
+BootstrapResult bootstrapLineFit(const Points2D& data, const Points2D& errors, int replicas = 1000,
+                                 double confidence = 0.6827, std::uint64_t seed = 12345, int nThreads = 0);
+
+#endif
@@ -3,51 +3,131 @@
 // Date: 28th November 2025
 
 #include "CustomFunctions.h"
+#include "MappedFile.h"
+#include "ColumnCache.h"
+#include "TextParsing.h"
+#include "CompressedInput.h"
+#include "ResultWriter.h"
+#include "LineFitAccumulator.h"
 #include <iostream>
-#include <fstream>
-#include <sstream>
 #include <cmath>
 #include <iomanip>
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// Write the parsed columns to the binary sidecar for next time. stamp was
+// taken before the file was read. Failing to write the cache is not an error.
+static void storeInCache(const std::string& filename, const SourceStamp& stamp, const Points2D& data) {
+    ColumnCache::write(filename, stamp, {data.xs(), data.ys()});
+}
 
 // Read data from CSV file containing x,y coordinates
-std::vector<std::pair<double, double>> readDataFile(const std::string& filename) {
-    std::vector<std::pair<double, double>> data;
-    std::ifstream file(filename);
+// gzip/bzip2 files are decompressed on a background thread while the text is
+// parsed. Plain files are memory-mapped and tokenised in place with std::from_chars, so no
+// intermediate strings are built for each line. The parsed columns are kept in
+// a binary sidecar next to the file, which later loads map directly while the
+// source is unchanged.
+Points2D readDataFile(const std::string& filename, bool verbose) {
+    Points2D data;
+
+    auto start = std::chrono::steady_clock::now();
+
+    ColumnCache cache(filename, 2);
+    if (cache.isValid()) {
+        // The sidecar already holds the columns in SoA layout, so copy them straight in
+        std::span<const double> xs = cache.column(0);
+        std::span<const double> ys = cache.column(1);
+        data.resize(cache.rows());
+        std::copy(xs.begin(), xs.end(), data.xData());
+        std::copy(ys.begin(), ys.end(), data.yData());
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (verbose) {
+            std::cout << "Loaded " << data.size() << " points from cache "
+                      << ColumnCache::sidecarPath(filename) << " in "
+                      << elapsed.count() * 1000.0 << " ms (warm load)" << std::endl;
+        }
+        return data;
+    }
+
+    // Stamp the source before reading it, so that a change made while it is
+    // parsed keeps the result out of the cache
+    SourceStamp stamp = ColumnCache::stamp(filename);
+
+    // Compressed input can't be mapped, so stream it through the decompressor
+    Compression compression = detectCompression(filename);
+    if (compression != Compression::None) {
+        PointStream stream(filename);
+        PointStream::Block block;
+        while (stream.next(block)) {
+            data.append(block);
+        }
+        if (stream.failed()) {
+            data.clear();
+            return data;
+        }
 
-    if (!file.is_open()) {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (verbose) {
+            std::cout << "Read " << data.size() << " points from " << compressionName(compression)
+                      << " file " << filename << " in " << elapsed.count() * 1000.0
+                      << " ms (cold load)" << std::endl;
+        }
+        storeInCache(filename, stamp, data);
+        return data;
+    }
+
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
         std::cerr << "Error: Could not open file " << filename << std::endl;
         return data;
     }
 
-    std::string line;
+    const char* p = file.begin();
+    const char* end = file.end();
+
+    // One point per line, so the newline count bounds the number of points
+    data.reserve(std::count(p, end, '\n') + 1);
+
     // Skip header line
-    std::getline(file, line);
+    p = findLineEnd(p, end);
+    if (p < end) p++;
 
     // Read data line by line
-    while (std::getline(file, line)) {
-        if (line.empty()) continue; // skip empty lines
+    while (p < end) {
+        const char* lineEnd = findLineEnd(p, end);
+
+        if (lineEnd != p) { // skip empty lines
+            double x, y;
+            if (parsePointLine(p, lineEnd, x, y)) {
+                data.emplace_back(x, y);
+            }
+        }
 
-        std::stringstream ss(line);
-        std::string x_str, y_str;
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+    }
 
-        if (std::getline(ss, x_str, ',') && std::getline(ss, y_str, ',')) {
-            double x = std::stod(x_str);
-            double y = std::stod(y_str);
-            data.push_back(std::make_pair(x, y));
-        }
+    // Report sustained read rate so slow loads are easy to spot
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double mbPerSecond = (elapsed.count() > 0.0) ? file.size() / elapsed.count() / 1.0e6 : 0.0;
+    if (verbose) {
+        std::cout << "Read " << file.size() << " bytes from " << filename << " in "
+                  << elapsed.count() * 1000.0 << " ms (" << mbPerSecond << " MB/s, cold load)" << std::endl;
     }
 
-    file.close();
+    storeInCache(filename, stamp, data);
     return data;
 }
 
 // Read error data from file (same format as data file)
-std::vector<std::pair<double, double>> readErrorFile(const std::string& filename) {
-    return readDataFile(filename); // same structure as data file
+Points2D readErrorFile(const std::string& filename, bool verbose) {
+    return readDataFile(filename, verbose); // same structure as data file
 }
 
 // Print first N lines to terminal with proper edge case handling
-void printNLines(const std::vector<std::pair<double, double>>& data, int N) {
+void printNLines(const Points2D& data, int N) {
     int numLines = N;
 
     // Edge case: if N is larger than data size, warn user and print only first 5
@@ -62,22 +142,21 @@ void printNLines(const std::vector<std::pair<double, double>>& data, int N) {
     std::cout << "-------------------" << std::endl;
     for (int i = 0; i < numLines; i++) {
         std::cout << "Point " << (i+1) << ": ("
-                  << data[i].first << ", "
-                  << data[i].second << ")" << std::endl;
+                  << data.x(i) << ", "
+                  << data.y(i) << ")" << std::endl;
     }
 }
 
 // Calculate magnitude of each (x,y) point treated as a vector from origin
 // Using the standard Euclidean norm: |v| = sqrt(x^2 + y^2)
-std::vector<double> calculateMagnitudes(const std::vector<std::pair<double, double>>& data) {
-    std::vector<double> magnitudes;
+std::vector<double> calculateMagnitudes(const Points2D& data) {
+    std::vector<double> magnitudes(data.size());
+    const double* x = data.xData();
+    const double* y = data.yData();
 
-    for (const auto& point : data) {
-        double x = point.first;
-        double y = point.second;
+    for (size_t i = 0; i < data.size(); i++) {
         // Calculate magnitude using Pythagorean theorem
-        double magnitude = std::sqrt(x*x + y*y);
-        magnitudes.push_back(magnitude);
+        magnitudes[i] = std::sqrt(x[i]*x[i] + y[i]*y[i]);
     }
 
     return magnitudes;
@@ -85,53 +164,70 @@ std::vector<double> calculateMagnitudes(const std::vector<std::pair<double, doub
 
 // Fit a straight line y = px + q using least squares method
 // Also calculate chi-squared/NDOF to assess goodness of fit
+// The points are reduced in fixed blocks by accumulateLineFit, which gives
+// the fit and chi-squared together in a single pass over the data (two if the
+// fit is too precise for chi-squared to come from the moments)
 std::pair<std::pair<double, double>, double> fitStraightLine(
-    const std::vector<std::pair<double, double>>& data,
-    const std::vector<std::pair<double, double>>& errors) {
+    const Points2D& data,
+    const Points2D& errors,
+    int nThreads) {
 
-    int N = data.size();
+    // Use y-component of error as sigma
+    LineFitAccumulator fit = accumulateLineFit(data.xData(), data.yData(), errors.yData(), data.size(), nThreads);
 
-    // Calculate sums needed for least squares formulas
-    double sum_x = 0.0, sum_y = 0.0, sum_xy = 0.0, sum_x2 = 0.0;
-
-    for (const auto& point : data) {
-        double x = point.first;
-        double y = point.second;
-        sum_x += x;
-        sum_y += y;
-        sum_xy += x * y;
-        sum_x2 += x * x;
-    }
-
-    // Apply least squares formulas to get slope (p) and intercept (q)
-    // p = (N*sum(xy) - sum(x)*sum(y)) / (N*sum(x^2) - sum(x)*sum(x))
-    double p = (N * sum_xy - sum_x * sum_y) / (N * sum_x2 - sum_x * sum_x);
-
-    // q = (sum(x^2)*sum(y) - sum(xy)*sum(x)) / (N*sum(x^2) - sum(x)*sum(x))
-    double q = (sum_x2 * sum_y - sum_xy * sum_x) / (N * sum_x2 - sum_x * sum_x);
-
-    // Calculate chi-squared: sum of (observed - expected)^2 / sigma^2
-    double chi_squared = 0.0;
+    // chi-squared per degree of freedom, NDOF = N - 2 for a straight line
+    return fit.result();
+}
 
-    for (size_t i = 0; i < data.size(); i++) {
-        double x_obs = data[i].first;
-        double y_obs = data[i].second;
-        double y_expected = p * x_obs + q; // fitted line value
+// Streaming version of calculateMagnitudes, one block at a time
+void calculateMagnitudes(PointStream& data, const std::function<void(const std::vector<double>&)>& consumer) {
+    PointStream::Block block;
+    std::vector<double> magnitudes;
 
-        // Use y-component of error as sigma
-        double sigma = errors[i].second;
+    while (data.next(block)) {
+        magnitudes.resize(block.size());
+        const double* x = block.xData();
+        const double* y = block.yData();
+        for (size_t i = 0; i < block.size(); i++) {
+            magnitudes[i] = std::sqrt(x[i] * x[i] + y[i] * y[i]);
+        }
+        consumer(magnitudes);
+    }
+}
 
-        // Add contribution to chi-squared
-        double residual = (y_obs - y_expected) / sigma;
-        chi_squared += residual * residual;
+// Streaming version of fitStraightLine
+// Walks the data and error streams in step, one block at a time, and walks
+// them again for the residuals if chi-squared cannot come from the moments
+std::pair<std::pair<double, double>, double> fitStraightLine(PointStream& data, PointStream& errors) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    PointStream::Block block, errorBlock;
+    LineFitAccumulator fit;
+
+    data.rewind();
+    errors.rewind();
+    while (data.next(block)) {
+        if (!errors.next(errorBlock) || errorBlock.size() != block.size()) {
+            std::cerr << "Error: Mismatch between data and error file sizes." << std::endl;
+            return std::make_pair(std::make_pair(nan, nan), nan);
+        }
+        fit.addBlock(block.xData(), block.yData(), errorBlock.yData(), block.size());
+    }
+    if (errors.next(errorBlock)) {
+        std::cerr << "Error: Mismatch between data and error file sizes." << std::endl;
+        return std::make_pair(std::make_pair(nan, nan), nan);
     }
 
-    // Calculate chi-squared per degree of freedom
-    // NDOF = N - number_of_parameters, for straight line we have 2 parameters (p and q)
-    int ndof = N - 2;
-    double chi2_ndof = chi_squared / ndof;
+    if (!fit.momentChiSquaredReliable()) {
+        double chi2 = 0.0;
+        data.rewind();
+        errors.rewind();
+        while (data.next(block) && errors.next(errorBlock)) {
+            chi2 += fit.residualChiSquared(block.xData(), block.yData(), errorBlock.yData(), block.size());
+        }
+        fit.setChiSquared(chi2);
+    }
 
-    return std::make_pair(std::make_pair(p, q), chi2_ndof);
+    return fit.result();
 }
 
 // Helper function for recursive power calculation with integer exponent
@@ -161,7 +257,7 @@ double powerRecursive(double x, double y) {
 // ========== Overloaded print functions ==========
 
 // Print N lines of data to terminal
-void printToTerminal(const std::vector<std::pair<double, double>>& data, int N) {
+void printToTerminal(const Points2D& data, int N) {
     printNLines(data, N);
 }
 
@@ -192,15 +288,56 @@ void printToTerminal(const std::pair<std::pair<double, double>, double>& fitResu
     }
 }
 
+// Print a weighted linear fit: each parameter with its error, then chi-squared
+void printToTerminal(const LinearFitResult& fitResult) {
+    std::cout << "\nWeighted Least Squares Fit Results:" << std::endl;
+    std::cout << "-----------------------------------" << std::endl;
+    if (!fitResult.valid) {
+        std::cout << "Fit failed (singular normal matrix)" << std::endl;
+        return;
+    }
+    for (size_t i = 0; i < fitResult.size(); i++) {
+        std::cout << "Coefficient of " << fitResult.names[i] << " = " << fitResult.parameters[i]
+                  << " +/- " << fitResult.error(i) << std::endl;
+    }
+    std::cout << "Chi-squared/NDOF = " << fitResult.chi2PerNdof() << std::endl;
+}
+
+// Print bootstrap uncertainties on p and q
+void printToTerminal(const BootstrapResult& bootstrap) {
+    std::cout << "\nBootstrap Uncertainties (" << bootstrap.replicas << " replicas, "
+              << bootstrap.confidence * 100.0 << "% intervals):" << std::endl;
+    std::cout << "--------------------------------------------" << std::endl;
+    if (!bootstrap.valid) {
+        std::cout << "Bootstrap failed: " << bootstrap.slopes.size() << " of " << bootstrap.replicas
+                  << " replicas gave a finite fit" << std::endl;
+        return;
+    }
+    if (bootstrap.dropped > 0) {
+        std::cout << bootstrap.dropped << " replicas with no finite fit were left out" << std::endl;
+    }
+    auto printInterval = [](const std::string& name, const BootstrapInterval& interval) {
+        std::cout << name << " = " << interval.nominal << " +/- " << interval.stdDev
+                  << "  [" << interval.lower << ", " << interval.upper << "]" << std::endl;
+    };
+    printInterval("p (slope)", bootstrap.slope);
+    printInterval("q (intercept)", bootstrap.intercept);
+}
+
 // ========== Overloaded save to file functions ==========
+// All three format through ResultWriter, which converts numbers with
+// std::to_chars into a large buffer and writes it out in big blocks.
+// The default precisions reproduce the previous iostream output exactly.
+// Status messages go to log (std::cout unless redirected, e.g. by a
+// background writer) and the return value says whether the file was written.
 
 // Save N lines of data to file
-void saveToFile(const std::vector<std::pair<double, double>>& data, int N, const std::string& filename) {
-    std::ofstream outfile(filename);
+bool saveToFile(const Points2D& data, int N, const std::string& filename, int precision, std::ostream& log) {
+    ResultWriter outfile(filename);
 
-    if (!outfile.is_open()) {
+    if (!outfile.isOpen()) {
         std::cerr << "Error: Could not create file " << filename << std::endl;
-        return;
+        return false;
     }
 
     int numLines = std::min(N, static_cast<int>(data.size()));
@@ -208,50 +345,65 @@ void saveToFile(const std::vector<std::pair<double, double>>& data, int N, const
         numLines = std::min(5, static_cast<int>(data.size()));
     }
 
-    outfile << "First " << numLines << " data points (x, y):" << std::endl;
+    outfile.setPrecision(precision);
+    outfile.write("First ").write(static_cast<long long>(numLines)).write(" data points (x, y):").newline();
     for (int i = 0; i < numLines; i++) {
-        outfile << data[i].first << ", " << data[i].second << std::endl;
+        outfile.write(data.x(i)).write(", ").write(data.y(i)).newline();
     }
 
-    outfile.close();
-    std::cout << "Data saved to " << filename << std::endl;
+    if (!outfile.close()) {
+        std::cerr << "Error: Could not write file " << filename << std::endl;
+        return false;
+    }
+    log << "Data saved to " << filename << " (" << outfile.summary() << ")" << std::endl;
+    return true;
 }
 
 // Save vector of doubles to file with a label
-void saveToFile(const std::vector<double>& values, const std::string& filename, const std::string& label) {
-    std::ofstream outfile(filename);
+bool saveToFile(const std::vector<double>& values, const std::string& filename, const std::string& label, int precision, std::ostream& log) {
+    ResultWriter outfile(filename);
 
-    if (!outfile.is_open()) {
+    if (!outfile.isOpen()) {
         std::cerr << "Error: Could not create file " << filename << std::endl;
-        return;
+        return false;
     }
 
-    outfile << label << ":" << std::endl;
+    outfile.setPrecision(precision);
+    outfile.write(label).write(":").newline();
     for (size_t i = 0; i < values.size(); i++) {
-        outfile << std::setprecision(8) << values[i] << std::endl;
+        outfile.write(values[i]).newline();
     }
 
-    outfile.close();
-    std::cout << "Results saved to " << filename << std::endl;
+    if (!outfile.close()) {
+        std::cerr << "Error: Could not write file " << filename << std::endl;
+        return false;
+    }
+    log << "Results saved to " << filename << " (" << outfile.summary() << ")" << std::endl;
+    return true;
 }
 
 // Save fit results to file
-void saveToFile(const std::pair<std::pair<double, double>, double>& fitResult, const std::string& filename) {
-    std::ofstream outfile(filename);
+bool saveToFile(const std::pair<std::pair<double, double>, double>& fitResult, const std::string& filename, int precision, std::ostream& log) {
+    ResultWriter outfile(filename);
 
-    if (!outfile.is_open()) {
+    if (!outfile.isOpen()) {
         std::cerr << "Error: Could not create file " << filename << std::endl;
-        return;
+        return false;
     }
 
     double p = fitResult.first.first;
     double q = fitResult.first.second;
     double chi2_ndof = fitResult.second;
 
-    outfile << "Least Squares Fit Results:" << std::endl;
-    outfile << "Fitted line: y = " << p << " * x + " << q << std::endl;
-    outfile << "Chi-squared/NDOF = " << chi2_ndof << std::endl;
+    outfile.setPrecision(precision);
+    outfile.write("Least Squares Fit Results:").newline();
+    outfile.write("Fitted line: y = ").write(p).write(" * x + ").write(q).newline();
+    outfile.write("Chi-squared/NDOF = ").write(chi2_ndof).newline();
 
-    outfile.close();
-    std::cout << "Fit results saved to " << filename << std::endl;
+    if (!outfile.close()) {
+        std::cerr << "Error: Could not write file " << filename << std::endl;
+        return false;
+    }
+    log << "Fit results saved to " << filename << " (" << outfile.summary() << ")" << std::endl;
+    return true;
 }
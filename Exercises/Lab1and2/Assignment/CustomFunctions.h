@@ -8,25 +8,48 @@
 #include <vector>
 #include <string>
 #include <utility>
+#include <functional>
+#include <iostream>
+#include "DataStream.h"
+#include "Points2D.h"
+#include "ResultWriter.h"
+#include "LinearFit.h"
+#include "Bootstrap.h"
+
+// All (x,y) data is held in the struct-of-arrays Points2D container. It
+// converts implicitly to and from std::vector<std::pair<double, double>>, so
+// code written against the old layout keeps compiling.
 
 // Function to read 2D coordinate data from file
-// Returns a vector of pairs representing (x,y) coordinates
-std::vector<std::pair<double, double>> readDataFile(const std::string& filename);
+// Returns the (x,y) coordinates as separate x and y columns
+// Set verbose to false to suppress the load-time message
+Points2D readDataFile(const std::string& filename, bool verbose = true);
 
 // Function to read error data from file
-std::vector<std::pair<double, double>> readErrorFile(const std::string& filename);
+Points2D readErrorFile(const std::string& filename, bool verbose = true);
 
 // Print first N lines of data to terminal
-void printNLines(const std::vector<std::pair<double, double>>& data, int N);
+void printNLines(const Points2D& data, int N);
 
 // Calculate magnitude of each vector (treating each point as position vector from origin)
-std::vector<double> calculateMagnitudes(const std::vector<std::pair<double, double>>& data);
+std::vector<double> calculateMagnitudes(const Points2D& data);
 
 // Fit straight line to data using least squares method
 // Returns parameters (slope, intercept) and chi-squared/NDOF
+// (see LineFitAccumulator.h to accumulate the same fit incrementally)
+// nThreads > 1 (or <= 0 for one per core) spreads the work over a thread
+// pool; the result is bit-identical whatever the thread count
 std::pair<std::pair<double, double>, double> fitStraightLine(
-    const std::vector<std::pair<double, double>>& data,
-    const std::vector<std::pair<double, double>>& errors);
+    const Points2D& data,
+    const Points2D& errors,
+    int nThreads = 1);
+
+// Streaming overloads: consume the files block by block in constant memory.
+// Magnitudes are handed to consumer one block at a time.
+void calculateMagnitudes(PointStream& data, const std::function<void(const std::vector<double>&)>& consumer);
+
+// Same fit as above, reading the data and error streams once, in step
+std::pair<std::pair<double, double>, double> fitStraightLine(PointStream& data, PointStream& errors);
 
 // Calculate x^y using recursion (y rounded to nearest integer)
 // Base case for y=0, y=1, and recursive for other values
@@ -36,13 +59,21 @@ double powerRecursive(double x, double y);
 double powerHelper(double base, int exponent);
 
 // Overloaded print functions for different data types
-void printToTerminal(const std::vector<std::pair<double, double>>& data, int N);
+void printToTerminal(const Points2D& data, int N);
 void printToTerminal(const std::vector<double>& values, const std::string& label);
 void printToTerminal(const std::pair<std::pair<double, double>, double>& fitResult);
+void printToTerminal(const LinearFitResult& fitResult);
+void printToTerminal(const BootstrapResult& bootstrap);
 
 // Overloaded save functions for writing results to files
-void saveToFile(const std::vector<std::pair<double, double>>& data, int N, const std::string& filename);
-void saveToFile(const std::vector<double>& values, const std::string& filename, const std::string& label);
-void saveToFile(const std::pair<std::pair<double, double>, double>& fitResult, const std::string& filename);
+// precision is the number of significant digits, or SHORTEST_ROUND_TRIP to
+// write each value exactly (see ResultWriter.h). The "saved to" message goes
+// to log. Returns false if the file could not be written.
+bool saveToFile(const Points2D& data, int N, const std::string& filename, int precision = 6,
+                std::ostream& log = std::cout);
+bool saveToFile(const std::vector<double>& values, const std::string& filename, const std::string& label,
+                int precision = 8, std::ostream& log = std::cout);
+bool saveToFile(const std::pair<std::pair<double, double>, double>& fitResult, const std::string& filename,
+                int precision = 6, std::ostream& log = std::cout);
 
 #endif
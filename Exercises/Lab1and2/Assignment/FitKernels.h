@@ -0,0 +1,51 @@
+// FitKernels.h
+// Vectorised kernels for the per-block moments of the straight-line fit
+// Date: October 2026
+//
+// LineFitAccumulator::addBlock spends nearly all its time summing over a
+// block of points. Here the points are split into sub-blocks of 512, and
+// every sum the fit needs is gathered in one pass over each sub-block:
+// offsets from the sub-block's first point, their squares and products, and
+// the same again weighted by 1/sigma^2 (for chi-squared). The centred
+// co-moments follow from these sums, and the sub-blocks are merged with the
+// same pairwise formula as LineFitAccumulator::merge.
+//
+// The loop is implemented three times - AVX-512, AVX2+FMA and plain scalar
+// code. The CPU is checked at run time, so the program still runs on
+// machines without AVX.
+
+#ifndef FITKERNELS_H
+#define FITKERNELS_H
+
+#include <cstddef>
+
+enum class FitKernel { Scalar, AVX2, AVX512 };
+
+// Means and centred co-moments of one block, unweighted (for p and q) and
+// weighted by 1/sigma^2 (for chi-squared)
+struct BlockMoments {
+    double mx = 0.0, my = 0.0;
+    double cxx = 0.0, cxy = 0.0, cyy = 0.0;
+    double w = 0.0;
+    double wmx = 0.0, wmy = 0.0;
+    double wcxx = 0.0, wcxy = 0.0, wcyy = 0.0;
+};
+
+// Compute the moments of n > 0 points. sigma may be nullptr (sigma = 1).
+BlockMoments blockMoments(const double* x, const double* y, const double* sigma, std::size_t n);
+
+// Best kernel this CPU supports
+FitKernel detectFitKernel();
+
+// Kernel used by blockMoments. Starts as AVX2 where available (AVX-512 gave
+// no further gain), unless the FIT_KERNEL environment variable is set to
+// scalar, avx2 or avx512.
+FitKernel activeFitKernel();
+
+// Force a kernel, e.g. for benchmarks. Asking for one the CPU lacks falls
+// back to the best supported one; returns the kernel actually selected.
+FitKernel setFitKernel(FitKernel kernel);
+
+const char* fitKernelName(FitKernel kernel);
+
+#endif
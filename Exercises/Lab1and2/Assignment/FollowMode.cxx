@@ -0,0 +1,224 @@
+// FollowMode.cxx
+// Implementation of the follow mode
+// Date: October 2026
+
+#include "FollowMode.h"
+#include "CustomFunctions.h"
+#include "FileFollower.h"
+#include "LineFitAccumulator.h"
+#include "TextParsing.h"
+#include <iostream>
+#include <filesystem>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <limits>
+#include <cmath>
+#include <csignal>
+#include <algorithm>
+
+namespace {
+
+volatile std::sig_atomic_t stopRequested = 0;
+
+void handleInterrupt(int) {
+    stopRequested = 1;
+}
+
+// Everything derived from the points seen so far
+struct FollowState {
+    LineFitAccumulator fit;
+    std::vector<double> magnitudes;
+    std::vector<double> fitX, fitY, fitSigma;              // points in the fit, for the residuals
+    std::deque<std::pair<double, double>> unmatchedPoints; // waiting for their errors
+    std::deque<double> unmatchedSigmas;                    // waiting for their points
+
+    void clear() {
+        *this = FollowState();
+    }
+};
+
+// Parse the "x,y" lines in text, skipping headers and malformed lines
+template <typename Consumer>
+void forEachPoint(const std::string& text, Consumer consumer) {
+    const char* p = text.data();
+    const char* end = p + text.size();
+    while (p < end) {
+        const char* lineEnd = findLineEnd(p, end);
+        double x, y;
+        if (parsePointLine(p, lineEnd, x, y)) consumer(x, y);
+        p = (lineEnd < end) ? lineEnd + 1 : end;
+    }
+}
+
+void printUsage() {
+    std::cerr << "Usage:\n"
+              << "  AnalyseData --follow [options] INPUT\n\n"
+              << "Options:\n"
+              << "  --errors FILE     error file, followed alongside INPUT for chi-squared\n"
+              << "  --interval MS     how often to check for new data (default: 200)\n"
+              << "  --emit MS         how often to print and save results (default: 1000)\n"
+              << "  --max-updates N   stop after N updates (default: run until Ctrl-C)\n"
+              << "  --outdir DIR      where to write the output files (default: .)\n";
+}
+
+} // namespace
+
+int runFollow(const FollowOptions& options) {
+    using Clock = std::chrono::steady_clock;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    std::filesystem::create_directories(options.outputDir);
+    std::string fitFile = (std::filesystem::path(options.outputDir) / "output_fit_results.txt").string();
+    std::string magnitudeFile = (std::filesystem::path(options.outputDir) / "output_magnitudes.txt").string();
+
+    FileFollower data(options.input);
+    FileFollower errors(options.errors.empty() ? std::string() : options.errors);
+    bool useErrors = !options.errors.empty();
+
+    FollowState state;
+    int updates = 0;
+    int updatesSinceEmit = 0;
+    int failedSaves = 0;
+    double lastLatency = 0.0, maxLatency = 0.0, totalLatency = 0.0;
+    Clock::time_point lastEmit = Clock::now();
+
+    std::signal(SIGINT, handleInterrupt);
+    std::cout << "Following " << options.input;
+    if (useErrors) std::cout << " with errors from " << options.errors;
+    std::cout << " (Ctrl-C to stop)" << std::endl;
+
+    // Print the current results and save them in the same format as the menu
+    auto emit = [&]() {
+        // A fit too precise for chi-squared from the moments needs the residuals
+        if (useErrors && !state.fit.momentChiSquaredReliable()) {
+            state.fit.setChiSquared(state.fit.residualChiSquared(state.fitX.data(), state.fitY.data(),
+                                                                 state.fitSigma.data(), state.fitX.size()));
+        }
+        std::pair<std::pair<double, double>, double> fitResult = state.fit.result();
+        if (!useErrors) fitResult.second = nan;
+
+        std::cout << "[follow] " << state.magnitudes.size() << " points, p = " << fitResult.first.first
+                  << ", q = " << fitResult.first.second << ", chi2/NDOF = " << fitResult.second
+                  << " | " << updatesSinceEmit << " update(s), latency last " << lastLatency * 1000.0
+                  << " ms, mean " << (updates > 0 ? totalLatency / updates * 1000.0 : 0.0)
+                  << " ms, max " << maxLatency * 1000.0 << " ms" << std::endl;
+
+        // saveToFile prints the reason; say that following carries on regardless
+        std::ostream quiet(nullptr);
+        bool saved = saveToFile(fitResult, fitFile, 6, quiet);
+        saved = saveToFile(state.magnitudes, magnitudeFile, "Magnitude of each data point", 8, quiet) && saved;
+        if (!saved) {
+            failedSaves++;
+            std::cerr << "[follow] results not saved to " << options.outputDir << ", still following" << std::endl;
+        }
+
+        updatesSinceEmit = 0;
+        lastEmit = Clock::now();
+    };
+
+    bool pendingEmit = false;
+    while (!stopRequested) {
+        Clock::time_point start = Clock::now();
+
+        std::string newData, newErrors;
+        bool gotData = data.poll(newData);
+        bool gotErrors = useErrors && errors.poll(newErrors);
+
+        // A truncated or replaced file invalidates everything derived from it;
+        // both files are re-read from the start so points and errors stay paired
+        if (data.reset() || (useErrors && errors.reset())) {
+            std::cout << "[follow] input was truncated or replaced, starting again" << std::endl;
+            state.clear();
+            if (!data.reset()) {
+                data.restart();
+                newData.clear();
+                gotData = data.poll(newData);
+            }
+            if (useErrors && !errors.reset()) {
+                errors.restart();
+                newErrors.clear();
+                gotErrors = errors.poll(newErrors);
+            }
+        }
+
+        if (gotData || gotErrors) {
+            forEachPoint(newData, [&](double x, double y) {
+                state.magnitudes.push_back(std::sqrt(x * x + y * y));
+                if (useErrors) state.unmatchedPoints.emplace_back(x, y);
+                else state.fit.add(x, y);
+            });
+            forEachPoint(newErrors, [&](double, double sigma) {
+                state.unmatchedSigmas.push_back(sigma);
+            });
+
+            // Points enter the fit once their errors have arrived
+            while (!state.unmatchedPoints.empty() && !state.unmatchedSigmas.empty()) {
+                auto [x, y] = state.unmatchedPoints.front();
+                state.fit.add(x, y, state.unmatchedSigmas.front());
+                state.fitX.push_back(x);
+                state.fitY.push_back(y);
+                state.fitSigma.push_back(state.unmatchedSigmas.front());
+                state.unmatchedPoints.pop_front();
+                state.unmatchedSigmas.pop_front();
+            }
+
+            std::chrono::duration<double> latency = Clock::now() - start;
+            lastLatency = latency.count();
+            maxLatency = std::max(maxLatency, lastLatency);
+            totalLatency += lastLatency;
+            updates++;
+            updatesSinceEmit++;
+            pendingEmit = true;
+        }
+
+        if (pendingEmit && Clock::now() - lastEmit >= std::chrono::milliseconds(options.emitMilliseconds)) {
+            emit();
+            pendingEmit = false;
+        }
+        if (options.maxUpdates > 0 && updates >= options.maxUpdates) break;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(options.pollMilliseconds));
+    }
+
+    if (pendingEmit) emit();
+    std::signal(SIGINT, SIG_DFL);
+    std::cout << "Stopped following after " << updates << " update(s)" << std::endl;
+    if (failedSaves > 0) {
+        std::cerr << "Error: results could not be saved " << failedSaves << " time(s)" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+int followMain(int argc, char* argv[]) {
+    FollowOptions options;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = (i + 1 < argc);
+
+        if (arg == "--follow") continue;
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return 0;
+        }
+        if (arg == "--errors" && hasValue) options.errors = argv[++i];
+        else if (arg == "--interval" && hasValue) options.pollMilliseconds = std::atoi(argv[++i]);
+        else if (arg == "--emit" && hasValue) options.emitMilliseconds = std::atoi(argv[++i]);
+        else if (arg == "--max-updates" && hasValue) options.maxUpdates = std::atoi(argv[++i]);
+        else if (arg == "--outdir" && hasValue) options.outputDir = argv[++i];
+        else if (arg.rfind("--", 0) == 0 || !options.input.empty()) {
+            std::cerr << "Error: Unexpected argument " << arg << std::endl;
+            printUsage();
+            return 1;
+        }
+        else options.input = arg;
+    }
+
+    if (options.input.empty()) {
+        printUsage();
+        return 1;
+    }
+    return runFollow(options);
+}
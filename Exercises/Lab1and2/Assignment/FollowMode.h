@@ -0,0 +1,28 @@
+// FollowMode.h
+// Follow mode: keep analysing an input file while it is being appended to
+// Date: October 2026
+
+#ifndef FOLLOWMODE_H
+#define FOLLOWMODE_H
+
+#include <string>
+
+// Settings for `AnalyseData --follow`
+struct FollowOptions {
+    std::string input;
+    std::string errors;        // optional; without it no chi-squared is reported
+    int pollMilliseconds = 200;  // how often the files are checked for new data
+    int emitMilliseconds = 1000; // how often results are printed and saved
+    int maxUpdates = 0;          // stop after this many updates (0 = until Ctrl-C)
+    std::string outputDir = ".";
+};
+
+// Watch the input (and error) file, parse only the newly appended lines,
+// update the fit and magnitudes incrementally and re-emit the results at the
+// configured cadence. Returns the process exit code.
+int runFollow(const FollowOptions& options);
+
+// Entry point for `AnalyseData --follow ...`
+int followMain(int argc, char* argv[]);
+
+#endif
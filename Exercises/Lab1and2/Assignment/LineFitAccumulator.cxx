@@ -0,0 +1,203 @@
+// LineFitAccumulator.cxx
+// Implementation of the streaming line fit accumulator
+// Date: October 2026
+
+#include "LineFitAccumulator.h"
+#include "FitKernels.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <future>
+#include <vector>
+#include <limits>
+#include <memory>
+#include <functional>
+#include <cmath>
+
+// Welford update, extended to weights and to the x-y co-moment
+void LineFitAccumulator::Moments::add(double x, double y, double weight) {
+    n++;
+    w += weight;
+    double dx = x - mx;
+    double dy = y - my;
+    mx += dx * weight / w;
+    my += dy * weight / w;
+    cxx += weight * dx * (x - mx);
+    cxy += weight * dx * (y - my);
+    cyy += weight * dy * (y - my);
+}
+
+// Pairwise combination (Chan et al.): the co-moments of the union are the
+// sum of the parts plus a correction for the distance between their means
+void LineFitAccumulator::Moments::merge(const Moments& other) {
+    if (other.n == 0) return;
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+
+    double total = w + other.w;
+    double dx = other.mx - mx;
+    double dy = other.my - my;
+    double f = w * other.w / total;
+
+    mx += dx * other.w / total;
+    my += dy * other.w / total;
+    cxx += other.cxx + dx * dx * f;
+    cxy += other.cxy + dx * dy * f;
+    cyy += other.cyy + dy * dy * f;
+    n += other.n;
+    w = total;
+}
+
+void LineFitAccumulator::add(double x, double y, double sigma) {
+    m_points.add(x, y, 1.0);
+    m_weighted.add(x, y, 1.0 / (sigma * sigma));
+    m_chiSquared = std::numeric_limits<double>::quiet_NaN();
+}
+
+void LineFitAccumulator::addBlock(const double* x, const double* y, const double* sigma, std::size_t n) {
+    if (n == 0) return;
+
+    // Means of the block, then co-moments about them, using the fastest
+    // kernel this CPU supports (see FitKernels.h)
+    BlockMoments block = blockMoments(x, y, sigma, n);
+
+    Moments points, weighted;
+    points.n = weighted.n = static_cast<long long>(n);
+    points.w = static_cast<double>(n);
+    points.mx = block.mx;
+    points.my = block.my;
+    points.cxx = block.cxx;
+    points.cxy = block.cxy;
+    points.cyy = block.cyy;
+    weighted.w = block.w;
+    weighted.mx = block.wmx;
+    weighted.my = block.wmy;
+    weighted.cxx = block.wcxx;
+    weighted.cxy = block.wcxy;
+    weighted.cyy = block.wcyy;
+
+    m_points.merge(points);
+    m_weighted.merge(weighted);
+    m_chiSquared = std::numeric_limits<double>::quiet_NaN();
+}
+
+void LineFitAccumulator::merge(const LineFitAccumulator& other) {
+    m_points.merge(other.m_points);
+    m_weighted.merge(other.m_weighted);
+    m_chiSquared = std::numeric_limits<double>::quiet_NaN();
+}
+
+double LineFitAccumulator::slope() const {
+    return m_points.cxy / m_points.cxx;
+}
+
+double LineFitAccumulator::intercept() const {
+    return m_points.my - slope() * m_points.mx;
+}
+
+// With residuals r = y - px - q measured about the weighted means,
+// sum w r^2 = W c^2 + cyy - 2p cxy + p^2 cxx, where c is the residual of the
+// weighted mean point itself (the cross term vanishes about the mean). The
+// last three terms nearly cancel when the line fits well.
+double LineFitAccumulator::momentResiduals() const {
+    double p = slope();
+    return m_weighted.cyy - 2.0 * p * m_weighted.cxy + p * p * m_weighted.cxx;
+}
+
+bool LineFitAccumulator::momentChiSquaredReliable() const {
+    if (m_weighted.n == 0 || m_weighted.cyy == 0.0) return true;
+    return momentResiduals() > 1e-6 * m_weighted.cyy;
+}
+
+double LineFitAccumulator::chiSquared() const {
+    if (!std::isnan(m_chiSquared)) return m_chiSquared;
+    if (m_weighted.n == 0) return 0.0;
+    if (!momentChiSquaredReliable()) return std::numeric_limits<double>::quiet_NaN();
+    double c = m_weighted.my - slope() * m_weighted.mx - intercept();
+    return m_weighted.w * c * c + momentResiduals();
+}
+
+// Residuals about the means, r = (y - my) - p (x - mx), so that a large
+// offset in x or y does not cost precision
+double LineFitAccumulator::residualChiSquared(const double* x, const double* y, const double* sigma,
+                                              std::size_t n) const {
+    double p = slope();
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; i++) {
+        double r = (y[i] - m_points.my) - p * (x[i] - m_points.mx);
+        double s = sigma ? sigma[i] : 1.0;
+        sum += (r / s) * (r / s);
+    }
+    return sum;
+}
+
+std::pair<std::pair<double, double>, double> LineFitAccumulator::result() const {
+    if (m_points.n < 2) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        return std::make_pair(std::make_pair(nan, nan), nan);
+    }
+    return std::make_pair(std::make_pair(slope(), intercept()),
+                          chiSquared() / static_cast<double>(ndof()));
+}
+
+LineFitAccumulator accumulateLineFit(const double* x, const double* y, const double* sigma,
+                                     std::size_t n, int nThreads) {
+    std::size_t nBlocks = (n + LINE_FIT_BLOCK - 1) / LINE_FIT_BLOCK;
+    std::vector<LineFitAccumulator> partials(nBlocks);
+
+    if (nThreads <= 0) nThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::unique_ptr<ThreadPool> pool;
+    if (nThreads > 1 && nBlocks >= 2) pool = std::make_unique<ThreadPool>(std::min<std::size_t>(nThreads, nBlocks));
+
+    // Call work(b) for every block. Which thread does it doesn't matter: each
+    // call depends only on its own block.
+    auto forEachBlock = [&](const std::function<void(std::size_t)>& work) {
+        auto run = [&work](std::size_t first, std::size_t last) {
+            for (std::size_t b = first; b < last; b++) work(b);
+        };
+        if (!pool) {
+            run(0, nBlocks);
+            return;
+        }
+        // A few tasks per thread, so an uneven finish doesn't leave cores idle
+        std::size_t nTasks = std::min<std::size_t>(nBlocks, static_cast<std::size_t>(pool->size()) * 4);
+        std::vector<std::future<void>> tasks;
+        for (std::size_t t = 0; t < nTasks; t++) {
+            std::size_t first = nBlocks * t / nTasks;
+            std::size_t last = nBlocks * (t + 1) / nTasks;
+            tasks.push_back(pool->submit([&run, first, last]() { run(first, last); }));
+        }
+        for (auto& task : tasks) task.get();
+    };
+
+    forEachBlock([&](std::size_t b) {
+        std::size_t start = b * LINE_FIT_BLOCK;
+        std::size_t count = std::min(LINE_FIT_BLOCK, n - start);
+        partials[b].addBlock(x + start, y + start, sigma ? sigma + start : nullptr, count);
+    });
+
+    // Fixed pairwise tree: (0+1), (2+3), ... then (01+23), ... and so on
+    for (std::size_t stride = 1; stride < nBlocks; stride *= 2) {
+        for (std::size_t i = 0; i + stride < nBlocks; i += 2 * stride) {
+            partials[i].merge(partials[i + stride]);
+        }
+    }
+    if (nBlocks == 0) return LineFitAccumulator();
+    LineFitAccumulator fit = partials[0];
+
+    // Too precise a fit for the moments: sum the residuals of each block,
+    // then add the block sums in order
+    if (!fit.momentChiSquaredReliable()) {
+        std::vector<double> blockChiSquared(nBlocks);
+        forEachBlock([&](std::size_t b) {
+            std::size_t start = b * LINE_FIT_BLOCK;
+            std::size_t count = std::min(LINE_FIT_BLOCK, n - start);
+            blockChiSquared[b] = fit.residualChiSquared(x + start, y + start, sigma ? sigma + start : nullptr, count);
+        });
+        double chi2 = 0.0;
+        for (double value : blockChiSquared) chi2 += value;
+        fit.setChiSquared(chi2);
+    }
+    return fit;
+}
@@ -0,0 +1,105 @@
+// LineFitAccumulator.h
+// Streaming, mergeable accumulator for the straight-line least squares fit
+// Date: October 2026
+//
+// Keeps centred (Welford-style) means and co-moments instead of raw sums of
+// x, y, xy and x^2, so the fit stays accurate when |x| is large compared to
+// its spread. Chi-squared is expanded in terms of the same moments, so the
+// full result is usually available after a single pass. When the line fits
+// the points so well that the expansion is lost in rounding, chi-squared has
+// to be summed from the residuals instead (accumulateLineFit does this
+// itself). Two accumulators combine exactly with merge(), so partial results
+// from threads, files or chunks can be added together in any grouping.
+//
+//   LineFitAccumulator fit;
+//   for (...) fit.add(x, y, sigma);
+//   auto result = fit.result();   // ((p, q), chi2/NDOF), as fitStraightLine
+
+#ifndef LINEFITACCUMULATOR_H
+#define LINEFITACCUMULATOR_H
+
+#include <cstddef>
+#include <utility>
+#include <limits>
+
+class LineFitAccumulator {
+public:
+    // Add one point with the y error sigma used for chi-squared
+    void add(double x, double y, double sigma);
+
+    // Add one point without an error (sigma = 1)
+    void add(double x, double y) { add(x, y, 1.0); }
+
+    // Add n points held in separate columns. sigma may be nullptr (sigma = 1).
+    // The block's own means are found first and the block is then merged in,
+    // which is as accurate as adding points one by one and much faster. The
+    // per-block loops are vectorised (see FitKernels.h).
+    void addBlock(const double* x, const double* y, const double* sigma, std::size_t n);
+
+    // Combine with the points accumulated by other
+    void merge(const LineFitAccumulator& other);
+
+    void reset() { *this = LineFitAccumulator(); }
+
+    long long count() const { return m_points.n; }
+    long long ndof() const { return m_points.n - 2; }
+
+    // Unweighted least squares line y = px + q, as fitStraightLine
+    double slope() const;
+    double intercept() const;
+
+    // sum over points of ((y - (px + q)) / sigma)^2 for the fitted line: the
+    // value from setChiSquared if there is one, otherwise the expansion in the
+    // moments, or NaN if that is below their rounding error
+    double chiSquared() const;
+
+    // False if the expansion of chi-squared in the moments cancels to less
+    // than 1e-6 of the weighted y co-moment, and so cannot be trusted
+    bool momentChiSquaredReliable() const;
+
+    // Sum ((y - (px + q)) / sigma)^2 over n points for this line. sigma may
+    // be nullptr (sigma = 1).
+    double residualChiSquared(const double* x, const double* y, const double* sigma, std::size_t n) const;
+
+    // Use chi2, summed from the residuals of every point, until more points
+    // are added
+    void setChiSquared(double chi2) { m_chiSquared = chi2; }
+
+    // ((p, q), chi2/NDOF)
+    std::pair<std::pair<double, double>, double> result() const;
+
+private:
+    // Weighted means and centred co-moments of a set of points.
+    // cxx = sum w (x - mx)^2, cxy = sum w (x - mx)(y - my), cyy likewise.
+    struct Moments {
+        long long n = 0;
+        double w = 0.0;
+        double mx = 0.0, my = 0.0;
+        double cxx = 0.0, cxy = 0.0, cyy = 0.0;
+
+        void add(double x, double y, double weight);
+        void merge(const Moments& other);
+    };
+
+    // Part of the chi-squared expansion that cancels for a good fit
+    double momentResiduals() const;
+
+    Moments m_points;    // every point with weight 1, for p and q
+    Moments m_weighted;  // weights 1/sigma^2, for chi-squared
+    double m_chiSquared = std::numeric_limits<double>::quiet_NaN(); // from the residuals, if set
+};
+
+// Points per block in accumulateLineFit
+const std::size_t LINE_FIT_BLOCK = 1 << 16;
+
+// Accumulate n points with a deterministic blocked reduction: the points are
+// cut into fixed blocks of LINE_FIT_BLOCK, each block is summed on its own
+// (on a pool of nThreads workers; <= 0 uses one per core), and the block
+// results are merged pairwise in a fixed tree order. If chi-squared cannot be
+// trusted from the moments, it is summed from the residuals in a second pass
+// over the same blocks. The result is bit-identical for any thread count.
+// sigma may be nullptr (sigma = 1).
+LineFitAccumulator accumulateLineFit(const double* x, const double* y, const double* sigma,
+                                     std::size_t n, int nThreads = 1);
+
+#endif
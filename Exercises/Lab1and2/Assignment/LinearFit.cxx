@@ -0,0 +1,248 @@
+// LinearFit.cxx
+// Implementation of the weighted linear least squares fitter
+// Date: October 2026
+
+#include "LinearFit.h"
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+
+namespace {
+
+// Points per block; the basis values of one block stay in L1 cache while
+// they are folded into the normal matrix
+const std::size_t blockSize = 256;
+
+// In-place Cholesky decomposition A = L L^T of the n x n row-major matrix a,
+// leaving L in the lower triangle. Returns false if A is not positive definite.
+bool choleskyDecompose(std::vector<double>& a, std::size_t n) {
+    for (std::size_t j = 0; j < n; j++) {
+        double diagonal = a[j * n + j];
+        for (std::size_t k = 0; k < j; k++) diagonal -= a[j * n + k] * a[j * n + k];
+        if (!(diagonal > 0.0)) return false;
+        double ljj = std::sqrt(diagonal);
+        a[j * n + j] = ljj;
+
+        for (std::size_t i = j + 1; i < n; i++) {
+            double sum = a[i * n + j];
+            for (std::size_t k = 0; k < j; k++) sum -= a[i * n + k] * a[j * n + k];
+            a[i * n + j] = sum / ljj;
+        }
+    }
+    return true;
+}
+
+// Solve L L^T x = b given the factor from choleskyDecompose
+std::vector<double> choleskySolve(const std::vector<double>& l, std::size_t n, std::vector<double> b) {
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t k = 0; k < i; k++) b[i] -= l[i * n + k] * b[k];
+        b[i] /= l[i * n + i];
+    }
+    for (std::size_t i = n; i-- > 0;) {
+        for (std::size_t k = i + 1; k < n; k++) b[i] -= l[k * n + i] * b[k];
+        b[i] /= l[i * n + i];
+    }
+    return b;
+}
+
+} // namespace
+
+double LinearFitResult::error(std::size_t i) const {
+    return std::sqrt(covarianceAt(i, i));
+}
+
+LinearFit::LinearFit(std::vector<BasisFunction> basis, std::vector<std::string> names)
+    : m_basis(std::move(basis)), m_names(std::move(names)) {
+    m_names.resize(m_basis.size());
+    for (std::size_t j = 0; j < m_names.size(); j++) {
+        if (m_names[j].empty()) m_names[j] = "f" + std::to_string(j);
+    }
+}
+
+LinearFit LinearFit::polynomial(int degree) {
+    LinearFit fit;
+    fit.m_degree = std::max(degree, 0);
+    for (int j = 0; j <= fit.m_degree; j++) {
+        fit.m_names.push_back(j == 0 ? "1" : (j == 1 ? "x" : "x^" + std::to_string(j)));
+    }
+    return fit;
+}
+
+void LinearFit::evaluateBasis(const double* x, std::size_t n, double* values, double centre,
+                              double scale) const {
+    if (m_degree >= 0) {
+        std::fill(values, values + n, 1.0);
+        if (m_degree >= 1) {
+            for (std::size_t i = 0; i < n; i++) values[n + i] = (x[i] - centre) / scale;
+        }
+        for (int j = 2; j <= m_degree; j++) {
+            const double* previous = values + (j - 1) * n;
+            double* row = values + j * n;
+            for (std::size_t i = 0; i < n; i++) row[i] = previous[i] * values[n + i];
+        }
+        return;
+    }
+
+    for (std::size_t j = 0; j < m_basis.size(); j++) {
+        double* row = values + j * n;
+        for (std::size_t i = 0; i < n; i++) row[i] = m_basis[j](x[i]);
+    }
+}
+
+LinearFitResult LinearFit::fit(const double* x, const double* y, const double* sigma, std::size_t n) const {
+    const std::size_t k = nParameters();
+    LinearFitResult result;
+    result.names = m_names;
+    result.ndof = static_cast<long long>(n) - static_cast<long long>(k);
+
+    // Polynomials: centre and scale x by its weighted mean and spread
+    double centre = 0.0, scale = 1.0;
+    if (m_degree >= 1 && n > 0) {
+        double sumW = 0.0, sumWx = 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            double s = sigma ? sigma[i] : 1.0;
+            sumW += 1.0 / (s * s);
+            sumWx += x[i] / (s * s);
+        }
+        centre = sumWx / sumW;
+        double sumWdx2 = 0.0;
+        for (std::size_t i = 0; i < n; i++) {
+            double s = sigma ? sigma[i] : 1.0;
+            sumWdx2 += (x[i] - centre) * (x[i] - centre) / (s * s);
+        }
+        scale = std::sqrt(sumWdx2 / sumW);
+        if (!std::isfinite(centre)) centre = 0.0;
+        if (!(scale > 0.0) || !std::isfinite(scale)) scale = 1.0;
+    }
+
+    // Accumulate the upper triangle of A, plus b
+    std::vector<double> a(k * k, 0.0), b(k, 0.0);
+
+    std::vector<double> basis(k * blockSize), weight(blockSize), wy(blockSize);
+    for (std::size_t start = 0; start < n; start += blockSize) {
+        std::size_t m = std::min(blockSize, n - start);
+        evaluateBasis(x + start, m, basis.data(), centre, scale);
+
+        for (std::size_t i = 0; i < m; i++) {
+            double s = sigma ? sigma[start + i] : 1.0;
+            weight[i] = 1.0 / (s * s);
+            wy[i] = weight[i] * y[start + i];
+        }
+
+        for (std::size_t j = 0; j < k; j++) {
+            const double* fj = basis.data() + j * m;
+            double bj = 0.0;
+            for (std::size_t i = 0; i < m; i++) bj += fj[i] * wy[i];
+            b[j] += bj;
+
+            for (std::size_t l = j; l < k; l++) {
+                const double* fl = basis.data() + l * m;
+                double ajl = 0.0;
+                for (std::size_t i = 0; i < m; i++) ajl += weight[i] * fj[i] * fl[i];
+                a[j * k + l] += ajl;
+            }
+        }
+    }
+    for (std::size_t j = 0; j < k; j++) {
+        for (std::size_t l = 0; l < j; l++) a[j * k + l] = a[l * k + j];
+    }
+
+    std::vector<double> factor = a;
+    if (k == 0 || !choleskyDecompose(factor, k)) {
+        std::cerr << "Error: Normal matrix is singular; the basis functions are not independent over these points." << std::endl;
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        result.parameters.assign(k, nan);
+        result.covariance.assign(k * k, nan);
+        result.chiSquared = nan;
+        return result;
+    }
+
+    result.parameters = choleskySolve(factor, k, b);
+
+    // Covariance = A^-1, one column at a time
+    result.covariance.assign(k * k, 0.0);
+    for (std::size_t j = 0; j < k; j++) {
+        std::vector<double> unit(k, 0.0);
+        unit[j] = 1.0;
+        std::vector<double> column = choleskySolve(factor, k, unit);
+        for (std::size_t i = 0; i < k; i++) result.covariance[i * k + j] = column[i];
+    }
+
+    // Chi-squared from the residuals in a second pass. The shortcut
+    // sum w y^2 - c.b cancels catastrophically when the fit is good.
+    double chiSquared = 0.0;
+    std::vector<double> model(blockSize);
+    for (std::size_t start = 0; start < n; start += blockSize) {
+        std::size_t m = std::min(blockSize, n - start);
+        evaluateBasis(x + start, m, basis.data(), centre, scale);
+
+        std::fill(model.begin(), model.begin() + m, 0.0);
+        for (std::size_t j = 0; j < k; j++) {
+            const double* fj = basis.data() + j * m;
+            for (std::size_t i = 0; i < m; i++) model[i] += result.parameters[j] * fj[i];
+        }
+        for (std::size_t i = 0; i < m; i++) {
+            double s = sigma ? sigma[start + i] : 1.0;
+            double pull = (y[start + i] - model[i]) / s;
+            chiSquared += pull * pull;
+        }
+    }
+    result.chiSquared = chiSquared;
+    result.valid = true;
+
+    // Back to powers of x: t^j = sum_l C(j, l) x^l (-centre)^(j-l) / scale^j,
+    // so parameters = T c and covariance = T C T^T with T as below
+    if (m_degree >= 1) {
+        result.centre = centre;
+        result.scale = scale;
+        result.centredParameters = result.parameters;
+
+        std::vector<double> t(k * k, 0.0);
+        for (std::size_t j = 0; j < k; j++) {
+            double binomial = 1.0;  // C(j, l)
+            for (std::size_t l = 0; l <= j; l++) {
+                t[l * k + j] = binomial * std::pow(-centre, static_cast<double>(j - l)) /
+                               std::pow(scale, static_cast<double>(j));
+                binomial = binomial * static_cast<double>(j - l) / static_cast<double>(l + 1);
+            }
+        }
+
+        std::vector<double> parameters(k, 0.0), tc(k * k, 0.0), covariance(k * k, 0.0);
+        for (std::size_t i = 0; i < k; i++) {
+            for (std::size_t j = 0; j < k; j++) {
+                parameters[i] += t[i * k + j] * result.centredParameters[j];
+                for (std::size_t l = 0; l < k; l++) tc[i * k + j] += t[i * k + l] * result.covariance[l * k + j];
+            }
+        }
+        for (std::size_t i = 0; i < k; i++) {
+            for (std::size_t j = 0; j < k; j++) {
+                for (std::size_t l = 0; l < k; l++) covariance[i * k + j] += tc[i * k + l] * t[j * k + l];
+            }
+        }
+        result.parameters = parameters;
+        result.covariance = covariance;
+    }
+    return result;
+}
+
+LinearFitResult LinearFit::fit(const Points2D& data, const Points2D& errors) const {
+    if (errors.size() != data.size()) {
+        std::cerr << "Error: Mismatch between data and error file sizes." << std::endl;
+        LinearFitResult result;
+        result.names = m_names;
+        return result;
+    }
+    return fit(data.xData(), data.yData(), errors.yData(), data.size());
+}
+
+double LinearFit::evaluate(const LinearFitResult& result, double x) const {
+    const bool centred = !result.centredParameters.empty();
+    const std::vector<double>& parameters = centred ? result.centredParameters : result.parameters;
+    std::vector<double> basis(nParameters());
+    evaluateBasis(&x, 1, basis.data(), result.centre, result.scale);
+
+    double value = 0.0;
+    for (std::size_t j = 0; j < nParameters(); j++) value += parameters[j] * basis[j];
+    return value;
+}
@@ -0,0 +1,90 @@
+// LinearFit.h
+// Weighted linear least squares over arbitrary basis functions
+// Date: October 2026
+//
+// Fits y = sum_j c_j f_j(x) by minimising chi-squared = sum ((y - model) / sigma)^2.
+// Unlike fitStraightLine, the errors weight every point in the fit itself.
+// The normal matrix A = sum w f f^T and vector b = sum w f y are built in a
+// single pass over the data, a block of points at a time, and A c = b is
+// solved by Cholesky decomposition. The inverse of A is the covariance matrix
+// of the parameters. Chi-squared is summed from the residuals in a second pass.
+//
+// Polynomials are solved in powers of t = (x - centre) / scale, with the
+// weighted mean and spread of x from a first pass, so that the normal matrix
+// stays well conditioned when x is far from zero. The parameters and
+// covariance are then converted back to powers of x.
+//
+//   LinearFit line = LinearFit::polynomial(1);     // c0 + c1 x
+//   LinearFitResult result = line.fit(data, errors);
+//   double slope = result.parameters[1], slopeError = result.error(1);
+
+#ifndef LINEARFIT_H
+#define LINEARFIT_H
+
+#include "Points2D.h"
+#include <vector>
+#include <string>
+#include <functional>
+#include <cstddef>
+
+// Parameters, their covariance and the goodness of fit
+struct LinearFitResult {
+    bool valid = false;               // false if the normal matrix was singular
+    std::vector<std::string> names;   // one per parameter
+    std::vector<double> parameters;
+    std::vector<double> covariance;   // n x n, row-major
+    double chiSquared = 0.0;
+    long long ndof = 0;               // points - parameters
+
+    // Polynomial fits only: the coefficients of t^j, t = (x - centre) / scale,
+    // as solved. evaluate() uses these, since summing the powers of x loses
+    // precision far from zero.
+    double centre = 0.0;
+    double scale = 1.0;
+    std::vector<double> centredParameters;
+
+    std::size_t size() const { return parameters.size(); }
+    double chi2PerNdof() const { return chiSquared / static_cast<double>(ndof); }
+    double covarianceAt(std::size_t i, std::size_t j) const { return covariance[i * size() + j]; }
+
+    // Standard error of parameter i, sqrt of the diagonal of the covariance
+    double error(std::size_t i) const;
+};
+
+class LinearFit {
+public:
+    using BasisFunction = std::function<double(double)>;
+
+    // User-supplied basis; names default to f0, f1, ...
+    explicit LinearFit(std::vector<BasisFunction> basis, std::vector<std::string> names = {});
+
+    // Polynomial c0 + c1 x + ... + ck x^k. Powers are built by repeated
+    // multiplication rather than through std::function calls.
+    static LinearFit polynomial(int degree);
+
+    std::size_t nParameters() const { return m_names.size(); }
+    const std::vector<std::string>& names() const { return m_names; }
+
+    // Fit n points held in separate columns. sigma may be nullptr (sigma = 1).
+    LinearFitResult fit(const double* x, const double* y, const double* sigma, std::size_t n) const;
+
+    // Fit data with the y column of errors as sigma, like fitStraightLine
+    LinearFitResult fit(const Points2D& data, const Points2D& errors) const;
+
+    // Value of the fitted model at x
+    double evaluate(const LinearFitResult& result, double x) const;
+
+private:
+    LinearFit() = default;
+
+    // Fill row j of values (stride n) with f_j(x[i]) for the n points.
+    // Polynomials use powers of (x - centre) / scale.
+    void evaluateBasis(const double* x, std::size_t n, double* values, double centre = 0.0,
+                       double scale = 1.0) const;
+
+    std::vector<BasisFunction> m_basis;  // empty for polynomials
+    std::vector<std::string> m_names;
+    int m_degree = -1;                   // >= 0 for polynomials
+};
+
+#endif
@@ -0,0 +1,181 @@
+// TestLineFits.cxx
+// Regression tests for the precision of the line fits and batched series fits
+// Date: October 2026
+//
+// Each check compares a fit against a residual sum in long double on data
+// where the fast formulas are known to lose precision. Returns 1 if any
+// check fails.
+
+#include "LineFitAccumulator.h"
+#include "BatchFit.h"
+#include "FitKernels.h"
+#include "LinearFit.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+
+namespace {
+
+int failures = 0;
+
+void check(const std::string& name, bool passed, double value, double expected) {
+    std::cout << (passed ? "PASS " : "FAIL ") << name << ": " << value << " (expected " << expected << ")"
+              << std::endl;
+    if (!passed) failures++;
+}
+
+bool close(double value, double expected, double tolerance) {
+    return std::fabs(value - expected) <= tolerance * std::fabs(expected);
+}
+
+// Points on y = slope x + intercept plus Gaussian noise of width sigma
+struct LineData {
+    std::vector<double> x, y, sigma;
+};
+
+LineData makeLine(std::size_t n, double offset, double step, double slope, double intercept, double sigma) {
+    LineData data;
+    std::mt19937_64 rng(12345);
+    std::normal_distribution<double> noise(0.0, sigma);
+    for (std::size_t i = 0; i < n; i++) {
+        double x = offset + step * static_cast<double>(i);
+        data.x.push_back(x);
+        data.y.push_back(slope * x + intercept + noise(rng));
+        data.sigma.push_back(sigma);
+    }
+    return data;
+}
+
+// sum ((y - (px + q)) / sigma)^2 in long double, for the fit's own p and q
+double residualSum(const LineData& data, double p, double q) {
+    long double sum = 0.0L;
+    for (std::size_t i = 0; i < data.x.size(); i++) {
+        long double r = static_cast<long double>(data.y[i]) - static_cast<long double>(p) * data.x[i] - q;
+        sum += (r / data.sigma[i]) * (r / data.sigma[i]);
+    }
+    return static_cast<double>(sum);
+}
+
+// chi-squared from accumulateLineFit, addBlock and per-point add
+void checkLineFit(const std::string& name, const LineData& data) {
+    std::size_t n = data.x.size();
+
+    LineFitAccumulator blocked = accumulateLineFit(data.x.data(), data.y.data(), data.sigma.data(), n);
+    double expected = residualSum(data, blocked.slope(), blocked.intercept());
+    check(name + ", accumulateLineFit", close(blocked.chiSquared(), expected, 1e-6), blocked.chiSquared(), expected);
+
+    // Without a residual pass the chi-squared must be right or NaN, never wrong
+    LineFitAccumulator block, points;
+    block.addBlock(data.x.data(), data.y.data(), data.sigma.data(), n);
+    for (std::size_t i = 0; i < n; i++) points.add(data.x[i], data.y[i], data.sigma[i]);
+    for (const LineFitAccumulator* fit : {&block, &points}) {
+        double chi2 = fit->chiSquared();
+        double reference = residualSum(data, fit->slope(), fit->intercept());
+        check(name + (fit == &block ? ", addBlock" : ", add"), std::isnan(chi2) || close(chi2, reference, 1e-6),
+              chi2, reference);
+
+        LineFitAccumulator withResiduals = *fit;
+        withResiduals.setChiSquared(fit->residualChiSquared(data.x.data(), data.y.data(), data.sigma.data(), n));
+        check(name + (fit == &block ? ", addBlock residuals" : ", add residuals"),
+              close(withResiduals.chiSquared(), reference, 1e-6), withResiduals.chiSquared(), reference);
+    }
+}
+
+// chi2/NDOF from fitSeriesBatch with every kernel, for series of 2 to 40
+// points cut from data
+void checkBatchFit(const std::string& name, const LineData& data) {
+    SeriesCollection series;
+    std::vector<LineData> parts;
+    for (std::size_t start = 0, length = 2; start + length <= data.x.size(); start += length, length = length % 40 + 1) {
+        LineData part;
+        part.x.assign(data.x.begin() + start, data.x.begin() + start + length);
+        part.y.assign(data.y.begin() + start, data.y.begin() + start + length);
+        part.sigma.assign(data.sigma.begin() + start, data.sigma.begin() + start + length);
+        series.addSeries(part.x.data(), part.y.data(), part.sigma.data(), length);
+        parts.push_back(part);
+    }
+
+    FitKernel defaultKernel = activeFitKernel();
+    for (FitKernel kernel : {FitKernel::Scalar, FitKernel::AVX2}) {
+        if (setFitKernel(kernel) != kernel) continue;
+        SeriesFitTable fits = fitSeriesBatch(series);
+
+        double worst = 0.0, worstValue = 0.0, worstExpected = 0.0;
+        for (std::size_t i = 0; i < parts.size(); i++) {
+            if (parts[i].x.size() < 3) continue;
+            double expected = residualSum(parts[i], fits.slope[i], fits.intercept[i]) /
+                              static_cast<double>(parts[i].x.size() - 2);
+            double difference = std::fabs(fits.chi2PerNdof[i] - expected) / expected;
+            if (!(difference <= worst)) {
+                worst = difference;
+                worstValue = fits.chi2PerNdof[i];
+                worstExpected = expected;
+            }
+        }
+        check(name + ", fitSeriesBatch " + fitKernelName(kernel) + " (worst series)", worst <= 1e-6, worstValue,
+              worstExpected);
+    }
+    setFitKernel(defaultKernel);
+}
+
+// A cubic fitted to x in [offset, offset + 100] must match the same points
+// fitted at offset 0: same chi-squared and the same curve
+void checkPolynomialOffset(const std::string& name, double offset) {
+    std::size_t n = 200;
+    std::mt19937_64 rng(12345);
+    std::normal_distribution<double> noise(0.0, 0.1);
+    std::vector<double> u(n), x(n), y(n), sigma(n, 0.1);
+    for (std::size_t i = 0; i < n; i++) {
+        u[i] = 0.5 * static_cast<double>(i);
+        x[i] = offset + u[i];
+        y[i] = 1.0 + 0.5 * u[i] - 0.02 * u[i] * u[i] + 1e-4 * u[i] * u[i] * u[i] + noise(rng);
+    }
+
+    LinearFit cubic = LinearFit::polynomial(3);
+    LinearFitResult shifted = cubic.fit(x.data(), y.data(), sigma.data(), n);
+    LinearFitResult reference = cubic.fit(u.data(), y.data(), sigma.data(), n);
+    check(name + ", valid", shifted.valid, shifted.valid, 1.0);
+    if (!shifted.valid || !reference.valid) return;
+    check(name + ", chi-squared", close(shifted.chiSquared, reference.chiSquared, 1e-6), shifted.chiSquared,
+          reference.chiSquared);
+
+    double worst = -1.0, worstValue = 0.0, worstExpected = 0.0;
+    for (std::size_t i = 0; i < n; i += 10) {
+        double value = cubic.evaluate(shifted, x[i]);
+        double expected = cubic.evaluate(reference, u[i]);
+        double difference = std::fabs(value - expected);
+        if (!(difference <= worst)) {
+            worst = difference;
+            worstValue = value;
+            worstExpected = expected;
+        }
+    }
+    check(name + ", evaluate (worst point)", worst <= 1e-6, worstValue, worstExpected);
+}
+
+} // namespace
+
+int main() {
+    std::cout.precision(10);
+
+    // Large offset in x and small errors: the moment expansion cancels
+    checkLineFit("offset 1e6, sigma 1e-3", makeLine(1000, 1e6, 1000.0, 2.5, -7.0, 1e-3));
+    checkBatchFit("offset 1e6, sigma 1e-3", makeLine(10000, 1e6, 1000.0, 2.5, -7.0, 1e-3));
+    checkLineFit("1e5 points, sigma 0.01", makeLine(100000, 0.0, 0.01, 3.0, 1.0, 0.01));
+
+    // Noisy data, where chi-squared comes straight from the moments
+    checkLineFit("sigma 1", makeLine(100000, 5.0, 1e-3, 0.5, 2.0, 1.0));
+    checkBatchFit("sigma 1", makeLine(10000, 5.0, 1e-3, 0.5, 2.0, 1.0));
+
+    // Polynomial far from x = 0: raw powers of x make the normal matrix singular
+    checkPolynomialOffset("cubic, offset 1e6", 1e6);
+
+    if (failures > 0) {
+        std::cout << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "All checks passed" << std::endl;
+    return 0;
+}
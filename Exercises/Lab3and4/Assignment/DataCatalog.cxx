@@ -0,0 +1,132 @@
+// DataCatalog.cxx
+// William Hopkins
+// October 2026
+
+#include "DataCatalog.h"
+#include "DataLoader.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <iomanip>
+#include <filesystem>
+#include <algorithm>
+#include <map>
+#include <chrono>
+
+DataCatalog::DataCatalog(const std::string& directory, const std::string& prefix)
+    : m_directory(directory) {
+
+    std::error_code ec;
+    std::filesystem::directory_iterator entries(directory, ec);
+    if (ec) {
+        std::cerr << "Error: Could not read directory " << directory << std::endl;
+        return;
+    }
+
+    // When a dataset has several copies, prefer .txt, then .txt.gz, then
+    // .txt.bz2, so the choice does not depend on the directory order
+    std::map<std::string, int> ranks;
+    std::vector<std::string> duplicates;
+    for (const auto& entry : entries) {
+        if (!entry.is_regular_file()) continue;
+        std::filesystem::path file = entry.path();
+        std::filesystem::path name = file.filename();
+        int rank = 0;
+        if (name.extension() == ".gz") rank = 1;
+        if (name.extension() == ".bz2") rank = 2;
+        if (rank > 0) name = name.stem();
+        std::string stem = name.stem().string();
+        if (name.extension() != ".txt" || stem.rfind(prefix, 0) != 0) continue;
+
+        auto it = m_datasets.find(stem);
+        if (it != m_datasets.end()) {
+            duplicates.push_back(stem);
+            if (rank >= ranks[stem]) continue;
+            it->second.path = file.string();
+            it->second.bytes = entry.file_size(ec);
+            ranks[stem] = rank;
+            continue;
+        }
+
+        Dataset dataset;
+        dataset.id = stem;
+        dataset.path = file.string();
+        dataset.bytes = entry.file_size(ec);
+        m_datasets.emplace(stem, std::move(dataset));
+        ranks[stem] = rank;
+        m_ids.push_back(stem);
+    }
+
+    std::sort(m_ids.begin(), m_ids.end());
+
+    std::sort(duplicates.begin(), duplicates.end());
+    duplicates.erase(std::unique(duplicates.begin(), duplicates.end()), duplicates.end());
+    for (const auto& id : duplicates) {
+        std::cout << "Warning: " << id << " has more than one copy in " << directory << "; using "
+                  << m_datasets.at(id).path << std::endl;
+    }
+}
+
+void DataCatalog::loadAll(int nThreads) {
+    auto start = std::chrono::steady_clock::now();
+
+    {
+        ThreadPool pool(nThreads);
+        for (auto& [id, dataset] : m_datasets) {
+            // Each entry is touched by exactly one task, so no locking is needed.
+            // Parallelism comes from overlapping files, so each file gets one thread.
+            Dataset* target = &dataset;
+            pool.submit([target]() {
+                auto fileStart = std::chrono::steady_clock::now();
+                target->values = readMysteryData(target->path, 1, false, &target->error);
+                if (target->error.empty() && target->values.empty()) target->error = "no data points";
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - fileStart;
+                target->loadSeconds = elapsed.count();
+            });
+        }
+    } // pool destructor waits for every load to finish
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_totalLoadSeconds = elapsed.count();
+
+    std::size_t points = 0, failed = 0;
+    for (const auto& [id, dataset] : m_datasets) {
+        points += dataset.values.size();
+        if (!dataset.error.empty()) failed++;
+    }
+    std::cout << "Loaded " << m_datasets.size() - failed << " files (" << points << " data points) from "
+              << m_directory << " in " << m_totalLoadSeconds * 1000.0 << " ms" << std::endl;
+    if (failed > 0) {
+        std::cerr << "Error: " << failed << " file(s) could not be loaded; see the catalog summary" << std::endl;
+    }
+}
+
+const Dataset* DataCatalog::find(const std::string& id) const {
+    auto it = m_datasets.find(id);
+    return (it == m_datasets.end()) ? nullptr : &it->second;
+}
+
+void DataCatalog::printSummary() const {
+    std::cout << std::left << std::setw(20) << "Dataset"
+              << std::right << std::setw(12) << "Points"
+              << std::setw(12) << "Bytes"
+              << std::setw(14) << "Load (ms)" << std::endl;
+    std::cout << std::string(58, '-') << std::endl;
+
+    double serialSeconds = 0.0;
+    for (const auto& id : m_ids) {
+        const Dataset& dataset = m_datasets.at(id);
+        serialSeconds += dataset.loadSeconds;
+        std::cout << std::left << std::setw(20) << dataset.id
+                  << std::right << std::setw(12) << dataset.values.size()
+                  << std::setw(12) << dataset.bytes
+                  << std::setw(14) << std::fixed << std::setprecision(3)
+                  << dataset.loadSeconds * 1000.0;
+        if (!dataset.error.empty()) std::cout << "  (" << dataset.error << ")";
+        std::cout << std::endl;
+    }
+    std::cout << std::string(58, '-') << std::endl;
+    std::cout << "Sum of per-file load times: " << serialSeconds * 1000.0 << " ms, wall time: "
+              << m_totalLoadSeconds * 1000.0 << " ms" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << std::setprecision(6);
+}
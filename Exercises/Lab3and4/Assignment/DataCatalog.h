@@ -0,0 +1,55 @@
+// DataCatalog.h
+// Discovers and loads every MysteryData file in a directory
+// William Hopkins
+// October 2026
+
+#ifndef DATACATALOG_H
+#define DATACATALOG_H
+
+#include <vector>
+#include <string>
+#include <map>
+#include <cstdint>
+
+// One loaded data file
+struct Dataset {
+    std::string id;            // file stem, e.g. "MysteryData20000"
+    std::string path;
+    std::uintmax_t bytes = 0;  // size of the source file
+    std::vector<double> values;
+    double loadSeconds = 0.0;  // wall time to load this file
+    std::string error;         // why the file could not be loaded; empty if it was
+};
+
+// Catalog of all data files in a directory. Files are found when the catalog
+// is constructed and loaded concurrently by loadAll(), so a batch job pays the
+// I/O cost once with the reads overlapped across files.
+class DataCatalog {
+public:
+    // Find every <prefix>*.txt file in directory (optionally compressed as
+    // .txt.gz or .txt.bz2). If a dataset has several copies, the plain .txt is
+    // used, then .txt.gz, then .txt.bz2, and the duplicate is reported.
+    explicit DataCatalog(const std::string& directory, const std::string& prefix = "MysteryData");
+
+    // Load every discovered file using at most nThreads worker threads
+    // (nThreads <= 0 uses one per hardware core)
+    void loadAll(int nThreads = 0);
+
+    std::size_t size() const { return m_datasets.size(); }
+    const std::vector<std::string>& ids() const { return m_ids; }
+
+    // Returns nullptr if there is no dataset with this id
+    const Dataset* find(const std::string& id) const;
+
+    // Table of id, points, size and load time for every dataset, with the
+    // error of any that failed to load
+    void printSummary() const;
+
+private:
+    std::string m_directory;
+    std::vector<std::string> m_ids;  // sorted
+    std::map<std::string, Dataset> m_datasets;
+    double m_totalLoadSeconds = 0.0; // wall time of the last loadAll()
+};
+
+#endif
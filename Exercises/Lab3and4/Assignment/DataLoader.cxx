@@ -0,0 +1,146 @@
+// DataLoader.cxx
+// William Hopkins
+// October 2026
+
+#include "DataLoader.h"
+#include "MappedFile.h"
+#include "ColumnCache.h"
+#include "TextParsing.h"
+#include "CompressedInput.h"
+#include "DataStream.h"
+#include <iostream>
+#include <thread>
+#include <functional>
+#include <chrono>
+#include <algorithm>
+
+namespace {
+
+// Don't bother spinning up a thread for less than this much text
+const std::size_t MIN_CHUNK_BYTES = 1 << 20;
+
+// Values parsed from one chunk, plus whether parsing stopped on a bad token
+struct ChunkResult {
+    std::vector<double> values;
+    bool stopped = false;
+};
+
+void parseChunk(const char* p, const char* end, ChunkResult& result) {
+    // Typical MysteryData lines are ~10 characters long
+    result.values.reserve(static_cast<std::size_t>(end - p) / 8);
+
+    while (true) {
+        while (p < end && isBlank(*p)) p++;
+        if (p == end) break;
+
+        double value;
+        if (!parseDouble(p, end, value)) {
+            result.stopped = true;
+            break;
+        }
+        result.values.push_back(value);
+    }
+}
+
+} // namespace
+
+std::vector<double> readMysteryData(const std::string& filename, int nThreads, bool verbose, std::string* error) {
+    std::vector<double> data;
+    if (error) error->clear();
+
+    auto start = std::chrono::steady_clock::now();
+
+    // Reuse the binary sidecar from an earlier load if the source is unchanged
+    ColumnCache cache(filename, 1);
+    if (cache.isValid()) {
+        std::span<const double> values = cache.column(0);
+        data.assign(values.begin(), values.end());
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (verbose) {
+            std::cout << "Read " << data.size() << " data points from " << filename
+                      << " (cached, " << elapsed.count() * 1000.0 << " ms, warm load)" << std::endl;
+        }
+        return data;
+    }
+
+    // Stamp the source before reading it, so that a change made while it is
+    // parsed keeps the result out of the cache
+    SourceStamp stamp = ColumnCache::stamp(filename);
+
+    // Compressed files are decompressed on a background thread while this
+    // thread parses the output
+    Compression compression = detectCompression(filename);
+    if (compression != Compression::None) {
+        ValueStream stream(filename);
+        ValueStream::Block block;
+        while (stream.next(block)) {
+            data.insert(data.end(), block.begin(), block.end());
+        }
+        if (stream.failed()) {
+            if (error) *error = "could not decompress " + std::string(compressionName(compression)) + " file";
+            data.clear();
+            return data;
+        }
+
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (verbose) {
+            std::cout << "Read " << data.size() << " data points from " << compressionName(compression)
+                      << " file " << filename << " (" << elapsed.count() * 1000.0
+                      << " ms, cold load)" << std::endl;
+        }
+        ColumnCache::write(filename, stamp, {data});
+        return data;
+    }
+
+    MappedFile file(filename);
+
+    if (!file.isOpen()) {
+        std::cerr << "Error: Could not open file " << filename << std::endl;
+        if (error) *error = "could not open file";
+        return data;
+    }
+
+    if (nThreads <= 0) {
+        nThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // Small files are parsed faster on one thread than the threads take to start
+    std::size_t maxUseful = std::max<std::size_t>(1, file.size() / MIN_CHUNK_BYTES);
+    nThreads = static_cast<int>(std::min<std::size_t>(nThreads, maxUseful));
+
+    std::vector<const char*> bounds = splitAtLineBoundaries(file.begin(), file.end(), nThreads);
+    std::size_t nChunks = bounds.size() - 1;
+    std::vector<ChunkResult> results(nChunks);
+
+    if (nChunks == 1) {
+        parseChunk(bounds[0], bounds[1], results[0]);
+    } else {
+        std::vector<std::thread> workers;
+        for (std::size_t i = 0; i < nChunks; i++) {
+            workers.emplace_back(parseChunk, bounds[i], bounds[i + 1], std::ref(results[i]));
+        }
+        for (auto& worker : workers) worker.join();
+    }
+
+    // Concatenate in file order; a bad token ends the data just like `file >> value`
+    std::size_t total = 0;
+    for (const auto& result : results) total += result.values.size();
+    data.reserve(total);
+
+    for (const auto& result : results) {
+        data.insert(data.end(), result.values.begin(), result.values.end());
+        if (result.stopped) break;
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    double mbPerSecond = (elapsed.count() > 0.0) ? file.size() / elapsed.count() / 1.0e6 : 0.0;
+    if (verbose) {
+        std::cout << "Read " << data.size() << " data points from " << filename
+                  << " (" << nChunks << " thread" << (nChunks == 1 ? "" : "s") << ", "
+                  << elapsed.count() * 1000.0 << " ms, " << mbPerSecond << " MB/s, cold load)" << std::endl;
+    }
+
+    // Failing to write the sidecar (e.g. read-only data directory) is not an error
+    ColumnCache::write(filename, stamp, {data});
+    return data;
+}
@@ -0,0 +1,23 @@
+// DataLoader.h
+// Loading of the one-column MysteryData files
+// William Hopkins
+// October 2026
+
+#ifndef DATALOADER_H
+#define DATALOADER_H
+
+#include <vector>
+#include <string>
+
+// Read whitespace-separated values from file, stopping at the first token that
+// is not a number (same behaviour as a `file >> value` loop).
+// The file is split at newline boundaries into nThreads chunks which are parsed
+// concurrently and concatenated in file order. nThreads <= 0 uses one thread
+// per hardware core. gzip and bzip2 files are detected from their magic bytes
+// and decompressed on a separate thread while being parsed. Set verbose to false to suppress the progress message
+// (e.g. when many files are loaded at once). If error is given, it is set to
+// the reason the file could not be read, or cleared on success.
+std::vector<double> readMysteryData(const std::string& filename, int nThreads = 0, bool verbose = true,
+                                   std::string* error = nullptr);
+
+#endif
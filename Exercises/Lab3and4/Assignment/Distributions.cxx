@@ -3,12 +3,139 @@
 // December 2025
 
 #include "Distributions.h"
+#include "Dual.h"
 #include <cmath>
 #include <iostream>
 #include <random>
 
 const double PI = 3.14159265358979323846;
 
+// Kernels for sumLogFunction. Each works on blocks of eight points with
+// eight independent partial results, so the compiler can vectorise the loop
+// without reordering a single running sum. target_clones builds an AVX2 copy
+// next to the baseline one and picks between them when the program starts.
+// Logarithms are the slow part, so they are taken of products of eight
+// factors (each >= 1 or bounded away from 0) instead of one at a time.
+// Each kernel is a template on the parameter type, compiled once for doubles
+// (sumLogFunction) and once for dual numbers (sumLogGradient).
+namespace {
+
+// Sum of (x - mean)^2
+template <typename T>
+__attribute__((always_inline)) inline T squaredOffsetsKernel(const double* x, int n, const T& mean) {
+    T partial[8]{};
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int j = 0; j < 8; j++) {
+            T d = x[i + j] - mean;
+            partial[j] += d * d;
+        }
+    }
+    T sum = ((partial[0] + partial[4]) + (partial[1] + partial[5])) +
+            ((partial[2] + partial[6]) + (partial[3] + partial[7]));
+    for (; i < n; i++) sum += (x[i] - mean) * (x[i] - mean);
+    return sum;
+}
+
+__attribute__((target_clones("avx2", "default")))
+double sumSquaredOffsets(const double* x, int n, double mean) {
+    return squaredOffsetsKernel(x, n, mean);
+}
+
+__attribute__((target_clones("avx2", "default")))
+Dual<2> sumSquaredOffsets(const double* x, int n, const Dual<2>& mean) {
+    return squaredOffsetsKernel(x, n, mean);
+}
+
+// Sum of log(1 + ((x - x0) / gamma)^2)
+template <typename T>
+__attribute__((always_inline)) inline T logOnePlusSquaresKernel(const double* x, int n, const T& x0, const T& gamma) {
+    T inverse = 1.0 / gamma;
+    T sum = 0.0;
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        T factor[8];
+        for (int j = 0; j < 8; j++) {
+            T t = (x[i + j] - x0) * inverse;
+            factor[j] = 1.0 + t * t;
+        }
+        sum += log(((factor[0] * factor[4]) * (factor[1] * factor[5])) *
+                   ((factor[2] * factor[6]) * (factor[3] * factor[7])));
+    }
+    for (; i < n; i++) {
+        T t = (x[i] - x0) * inverse;
+        sum += log(1.0 + t * t);
+    }
+    return sum;
+}
+
+__attribute__((target_clones("avx2", "default")))
+double sumLogOnePlusSquares(const double* x, int n, double x0, double gamma) {
+    return logOnePlusSquaresKernel(x, n, x0, gamma);
+}
+
+__attribute__((target_clones("avx2", "default")))
+Dual<2> sumLogOnePlusSquares(const double* x, int n, const Dual<2>& x0, const Dual<2>& gamma) {
+    return logOnePlusSquaresKernel(x, n, x0, gamma);
+}
+
+// Crystal Ball pieces: the sum of -t^2/2 over the core, the sum of
+// log(B - t) over the tail, and the number of points in the tail
+template <typename T>
+struct CrystalBallSums {
+    T core = 0.0;
+    T logTail = 0.0;
+    double tailCount = 0.0;
+};
+
+template <typename T>
+__attribute__((always_inline)) inline CrystalBallSums<T> crystalBallKernel(const double* x, int n, const T& mean,
+                                                                           const T& sigma, const T& alpha, const T& B) {
+    CrystalBallSums<T> sums;
+    T inverse = 1.0 / sigma;
+    T core[8]{};
+    double tail[8] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        // Both branches are computed and one is selected, so the loop has no
+        // data-dependent jumps to mispredict when core and tail points mix
+        T factor[8];
+        for (int j = 0; j < 8; j++) {
+            T t = (x[i + j] - mean) * inverse;
+            double inTail = (t > -alpha) ? 0.0 : 1.0;
+            core[j] += (1.0 - inTail) * (-0.5 * t * t);
+            factor[j] = 1.0 + inTail * (B - t - 1.0);
+            tail[j] += inTail;
+        }
+        sums.logTail += log(((factor[0] * factor[4]) * (factor[1] * factor[5])) *
+                            ((factor[2] * factor[6]) * (factor[3] * factor[7])));
+    }
+    sums.core = ((core[0] + core[4]) + (core[1] + core[5])) + ((core[2] + core[6]) + (core[3] + core[7]));
+    sums.tailCount = ((tail[0] + tail[4]) + (tail[1] + tail[5])) + ((tail[2] + tail[6]) + (tail[3] + tail[7]));
+    for (; i < n; i++) {
+        T t = (x[i] - mean) * inverse;
+        if (t > -alpha) sums.core += -0.5 * t * t;
+        else {
+            sums.logTail += log(B - t);
+            sums.tailCount += 1.0;
+        }
+    }
+    return sums;
+}
+
+__attribute__((target_clones("avx2", "default")))
+CrystalBallSums<double> crystalBallSums(const double* x, int n, double mean, double sigma, double alpha, double B) {
+    return crystalBallKernel(x, n, mean, sigma, alpha, B);
+}
+
+__attribute__((target_clones("avx2", "default")))
+CrystalBallSums<Dual<4>> crystalBallSums(const double* x, int n, const Dual<4>& mean, const Dual<4>& sigma,
+                                         const Dual<4>& alpha, const Dual<4>& B) {
+    return crystalBallKernel(x, n, mean, sigma, alpha, B);
+}
+
+} // namespace
+
 // Normal Distribution
 
 NormalDistribution::NormalDistribution(double mean, double sigma, double range_min,
@@ -18,10 +145,63 @@ NormalDistribution::NormalDistribution(double mean, double sigma, double range_m
 
 NormalDistribution::~NormalDistribution() {}
 
-double NormalDistribution::callFunction(double x) {
+template <typename T>
+T NormalDistribution::density(double x, const T& mean, const T& sigma) {
     // Gaussian: f(x) = (1 / (σ√(2π))) * exp(-(1/2)*((x-μ)/σ)²)
-    double exponent = -0.5 * ((x - m_mean) / m_sigma) * ((x - m_mean) / m_sigma);
-    return (1.0 / (m_sigma * sqrt(2.0 * PI))) * exp(exponent);
+    T t = (x - mean) / sigma;
+    return (1.0 / (sigma * sqrt(2.0 * PI))) * exp(-0.5 * t * t);
+}
+
+double NormalDistribution::callFunction(double x) {
+    return density(x, m_mean, m_sigma);
+}
+
+bool NormalDistribution::hasGradient() {
+    return true;
+}
+
+void NormalDistribution::callFunctionGradient(const double* x, int n, double* values, double* gradients) {
+    Dual<2> mean = Dual<2>::variable(m_mean, 0), sigma = Dual<2>::variable(m_sigma, 1);
+    for (int i = 0; i < n; i++) {
+        Dual<2> f = density(x[i], mean, sigma);
+        values[i] = f.value;
+        gradients[2 * i] = f.d[0];
+        gradients[2 * i + 1] = f.d[1];
+    }
+}
+
+std::vector<std::string> NormalDistribution::parameterNames() {
+    return {"mean", "sigma"};
+}
+
+std::vector<double> NormalDistribution::getParameters() {
+    return {m_mean, m_sigma};
+}
+
+void NormalDistribution::setParameters(const std::vector<double>& params) {
+    m_mean = params[0];
+    m_sigma = params[1];
+    invalidateIntegral();
+}
+
+// σ > 0
+std::pair<double, double> NormalDistribution::naturalBounds(int i) {
+    if (i == 1) return std::make_pair(0.0, INFINITY);
+    return std::make_pair(-INFINITY, INFINITY);
+}
+
+double NormalDistribution::sumLogFunction(const double* x, int n) {
+    // log f(x) = -(1/2)((x-μ)/σ)² - log(σ√(2π))
+    return -0.5 * sumSquaredOffsets(x, n, m_mean) / (m_sigma * m_sigma) - n * log(m_sigma * sqrt(2.0 * PI));
+}
+
+double NormalDistribution::sumLogGradient(const double* x, int n, double* gradient) {
+    // Same closed form as sumLogFunction, in dual numbers
+    Dual<2> mean = Dual<2>::variable(m_mean, 0), sigma = Dual<2>::variable(m_sigma, 1);
+    Dual<2> sum = -0.5 * sumSquaredOffsets(x, n, mean) / (sigma * sigma) - n * log(sigma * sqrt(2.0 * PI));
+    gradient[0] += sum.d[0];
+    gradient[1] += sum.d[1];
+    return sum.value;
 }
 
 void NormalDistribution::printInfo() {
@@ -80,10 +260,64 @@ CauchyLorentzDistribution::CauchyLorentzDistribution(double x0, double gamma,
 
 CauchyLorentzDistribution::~CauchyLorentzDistribution() {}
 
-double CauchyLorentzDistribution::callFunction(double x) {
+template <typename T>
+T CauchyLorentzDistribution::density(double x, const T& x0, const T& gamma) {
     // Cauchy-Lorentz: f(x) = 1 / (πγ * [1 + ((x-x₀)/γ)²])
-    double term = (x - m_x0) / m_gamma;
-    return 1.0 / (PI * m_gamma * (1.0 + term * term));
+    T term = (x - x0) / gamma;
+    return 1.0 / (PI * gamma * (1.0 + term * term));
+}
+
+double CauchyLorentzDistribution::callFunction(double x) {
+    return density(x, m_x0, m_gamma);
+}
+
+bool CauchyLorentzDistribution::hasGradient() {
+    return true;
+}
+
+void CauchyLorentzDistribution::callFunctionGradient(const double* x, int n, double* values, double* gradients) {
+    Dual<2> x0 = Dual<2>::variable(m_x0, 0), gamma = Dual<2>::variable(m_gamma, 1);
+    for (int i = 0; i < n; i++) {
+        Dual<2> f = density(x[i], x0, gamma);
+        values[i] = f.value;
+        gradients[2 * i] = f.d[0];
+        gradients[2 * i + 1] = f.d[1];
+    }
+}
+
+std::vector<std::string> CauchyLorentzDistribution::parameterNames() {
+    return {"x0", "gamma"};
+}
+
+std::vector<double> CauchyLorentzDistribution::getParameters() {
+    return {m_x0, m_gamma};
+}
+
+void CauchyLorentzDistribution::setParameters(const std::vector<double>& params) {
+    m_x0 = params[0];
+    m_gamma = params[1];
+    invalidateIntegral();
+}
+
+// γ > 0
+std::pair<double, double> CauchyLorentzDistribution::naturalBounds(int i) {
+    if (i == 1) return std::make_pair(0.0, INFINITY);
+    return std::make_pair(-INFINITY, INFINITY);
+}
+
+double CauchyLorentzDistribution::sumLogFunction(const double* x, int n) {
+    // log f(x) = -log(πγ) - log(1 + ((x-x₀)/γ)²)
+    return -n * log(PI * m_gamma) - sumLogOnePlusSquares(x, n, m_x0, m_gamma);
+}
+
+double CauchyLorentzDistribution::sumLogGradient(const double* x, int n, double* gradient) {
+    // Same closed form as sumLogFunction, in dual numbers
+    Dual<2> x0 = Dual<2>::variable(m_x0, 0), gamma = Dual<2>::variable(m_gamma, 1);
+    Dual<2> logs = sumLogOnePlusSquares(x, n, x0, gamma);
+    Dual<2> sum = -n * log(PI * gamma) - logs;
+    gradient[0] += sum.d[0];
+    gradient[1] += sum.d[1];
+    return sum.value;
 }
 
 void CauchyLorentzDistribution::printInfo() {
@@ -144,43 +378,116 @@ CrystalBallDistribution::CrystalBallDistribution(double mean, double sigma, doub
 
 CrystalBallDistribution::~CrystalBallDistribution() {}
 
-void CrystalBallDistribution::computeConstants() {
-    // Compute constants A, B, N
-    double abs_alpha = fabs(m_alpha);
+template <typename T>
+CrystalBallDistribution::Shape<T> CrystalBallDistribution::makeShape(const T& mean, const T& sigma,
+                                                                     const T& alpha, const T& n) {
+    Shape<T> shape{mean, sigma, alpha, n};
+    T abs_alpha = fabs(alpha);
 
     // A = (n/|α|)^n * exp(-|α|²/2)
-    m_A = pow(m_n / abs_alpha, m_n) * exp(-abs_alpha * abs_alpha / 2.0);
+    shape.logA = n * log(n / abs_alpha) - abs_alpha * abs_alpha / 2.0;
 
     // B = n/|α| - |α|
-    m_B = m_n / abs_alpha - abs_alpha;
+    shape.B = n / abs_alpha - abs_alpha;
 
     // C = (n/|α|) * (1/(n-1)) * exp(-|α|²/2)
-    m_C = (m_n / abs_alpha) * (1.0 / (m_n - 1.0)) * exp(-abs_alpha * abs_alpha / 2.0);
+    shape.C = (n / abs_alpha) * (1.0 / (n - 1.0)) * exp(-abs_alpha * abs_alpha / 2.0);
 
     // D = sqrt(π/2) * (1 + erf(|α|/√2))
-    m_D = sqrt(PI / 2.0) * (1.0 + erf(abs_alpha / sqrt(2.0)));
+    shape.D = sqrt(PI / 2.0) * (1.0 + erf(abs_alpha / sqrt(2.0)));
 
     // N = 1 / (σ(C + D))
-    m_N = 1.0 / (m_sigma * (m_C + m_D));
+    shape.N = 1.0 / (sigma * (shape.C + shape.D));
+    return shape;
 }
 
-double CrystalBallDistribution::callFunction(double x) {
+void CrystalBallDistribution::computeConstants() {
+    m_shape = makeShape(m_mean, m_sigma, m_alpha, m_n);
+    m_A = exp(m_shape.logA);
+    m_B = m_shape.B;
+    m_C = m_shape.C;
+    m_D = m_shape.D;
+    m_N = m_shape.N;
+}
+
+template <typename T>
+T CrystalBallDistribution::density(double x, const Shape<T>& shape) {
     // Standardized variable
-    double t = (x - m_mean) / m_sigma;
+    T t = (x - shape.mean) / shape.sigma;
 
     // Crystal Ball function has two regions:
     // Gaussian core for t > -α
     // Power law tail for t ≤ -α
 
-    if (t > -m_alpha) {
+    if (t > -shape.alpha) {
         // Gaussian part: exp(-(x-x̄)²/(2σ²))
-        return m_N * exp(-t * t / 2.0);
+        return shape.N * exp(-0.5 * t * t);
     } else {
         // Power law tail: A * (B - t)^(-n)
-        return m_N * m_A * pow(m_B - t, -m_n);
+        return shape.N * exp(shape.logA - shape.n * log(shape.B - t));
+    }
+}
+
+double CrystalBallDistribution::callFunction(double x) {
+    return density(x, m_shape);
+}
+
+bool CrystalBallDistribution::hasGradient() {
+    return true;
+}
+
+void CrystalBallDistribution::callFunctionGradient(const double* x, int n, double* values, double* gradients) {
+    // The constants and their derivatives are worked out once for all points
+    Shape<Dual<4>> shape = makeShape(Dual<4>::variable(m_mean, 0), Dual<4>::variable(m_sigma, 1),
+                                     Dual<4>::variable(m_alpha, 2), Dual<4>::variable(m_n, 3));
+    for (int i = 0; i < n; i++) {
+        Dual<4> f = density(x[i], shape);
+        values[i] = f.value;
+        for (int j = 0; j < 4; j++) gradients[4 * i + j] = f.d[j];
     }
 }
 
+std::vector<std::string> CrystalBallDistribution::parameterNames() {
+    return {"mean", "sigma", "alpha", "n"};
+}
+
+std::vector<double> CrystalBallDistribution::getParameters() {
+    return {m_mean, m_sigma, m_alpha, m_n};
+}
+
+void CrystalBallDistribution::setParameters(const std::vector<double>& params) {
+    m_mean = params[0];
+    m_sigma = params[1];
+    m_alpha = params[2];
+    m_n = params[3];
+    computeConstants();
+    invalidateIntegral();
+}
+
+// σ > 0 and α > 0, and n > 1 so that C (and the tail's integral) is finite
+std::pair<double, double> CrystalBallDistribution::naturalBounds(int i) {
+    if (i == 1 || i == 2) return std::make_pair(0.0, INFINITY);
+    if (i == 3) return std::make_pair(1.0, INFINITY);
+    return std::make_pair(-INFINITY, INFINITY);
+}
+
+double CrystalBallDistribution::sumLogFunction(const double* x, int n) {
+    // log f = log N - t²/2 in the core and log N + log A - n log(B - t) in the
+    // tail
+    CrystalBallSums<double> sums = crystalBallSums(x, n, m_mean, m_sigma, m_alpha, m_B);
+    return n * log(m_N) + sums.core + sums.tailCount * m_shape.logA - m_n * sums.logTail;
+}
+
+double CrystalBallDistribution::sumLogGradient(const double* x, int n, double* gradient) {
+    // Same closed form as sumLogFunction, in dual numbers
+    Shape<Dual<4>> shape = makeShape(Dual<4>::variable(m_mean, 0), Dual<4>::variable(m_sigma, 1),
+                                     Dual<4>::variable(m_alpha, 2), Dual<4>::variable(m_n, 3));
+    CrystalBallSums<Dual<4>> sums = crystalBallSums(x, n, shape.mean, shape.sigma, shape.alpha, shape.B);
+    Dual<4> sum = n * log(shape.N) + sums.core + sums.tailCount * shape.logA - shape.n * sums.logTail;
+    for (int j = 0; j < 4; j++) gradient[j] += sum.d[j];
+    return sum.value;
+}
+
 void CrystalBallDistribution::printInfo() {
     std::cout << "\n=== Crystal Ball Distribution ===" << std::endl;
     std::cout << "Mean (x̄): " << m_mean << std::endl;
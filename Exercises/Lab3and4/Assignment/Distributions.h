@@ -20,9 +20,24 @@ public:
     void printInfo() override;
     std::vector<double> metropolisSample(int n_samples, double proposal_width = 1.0);
 
+    std::vector<std::string> parameterNames() override;
+    std::vector<double> getParameters() override;
+    void setParameters(const std::vector<double>& params) override;
+    double sumLogFunction(const double* x, int n) override;
+    bool hasGradient() override;
+    void callFunctionGradient(const double* x, int n, double* values, double* gradients) override;
+    double sumLogGradient(const double* x, int n, double* gradient) override;
+
+protected:
+    std::pair<double, double> naturalBounds(int i) override;
+
 private:
     double m_mean;    // μ parameter
     double m_sigma;   // σ parameter
+
+    // f(x) for double or dual-number (Dual.h) parameters
+    template <typename T>
+    static T density(double x, const T& mean, const T& sigma);
 };
 
 // Cauchy-Lorentz distribution
@@ -35,9 +50,24 @@ public:
     void printInfo() override;
     std::vector<double> metropolisSample(int n_samples, double proposal_width = 1.0);
 
+    std::vector<std::string> parameterNames() override;
+    std::vector<double> getParameters() override;
+    void setParameters(const std::vector<double>& params) override;
+    double sumLogFunction(const double* x, int n) override;
+    bool hasGradient() override;
+    void callFunctionGradient(const double* x, int n, double* values, double* gradients) override;
+    double sumLogGradient(const double* x, int n, double* gradient) override;
+
+protected:
+    std::pair<double, double> naturalBounds(int i) override;
+
 private:
     double m_x0;      // x₀ location parameter
     double m_gamma;   // γ scale parameter
+
+    // f(x) for double or dual-number (Dual.h) parameters
+    template <typename T>
+    static T density(double x, const T& x0, const T& gamma);
 };
 
 // Crystal Ball distribution (used in particle physics!)
@@ -51,6 +81,17 @@ public:
     void printInfo() override;
     std::vector<double> metropolisSample(int n_samples, double proposal_width = 1.0);
 
+    std::vector<std::string> parameterNames() override;
+    std::vector<double> getParameters() override;
+    void setParameters(const std::vector<double>& params) override;
+    double sumLogFunction(const double* x, int n) override;
+    bool hasGradient() override;
+    void callFunctionGradient(const double* x, int n, double* values, double* gradients) override;
+    double sumLogGradient(const double* x, int n, double* gradient) override;
+
+protected:
+    std::pair<double, double> naturalBounds(int i) override;
+
 private:
     double m_mean;    // x̄ parameter
     double m_sigma;   // σ parameter
@@ -64,6 +105,21 @@ private:
     double m_D;
     double m_N;
 
+    // Parameters with the constants derived from them, for double or
+    // dual-number (Dual.h) parameters. log A is kept rather than A, which
+    // overflows for large n/|α|.
+    template <typename T>
+    struct Shape {
+        T mean, sigma, alpha, n;
+        T logA, B, C, D, N;
+    };
+    Shape<double> m_shape;
+
+    template <typename T>
+    static Shape<T> makeShape(const T& mean, const T& sigma, const T& alpha, const T& n);
+    template <typename T>
+    static T density(double x, const Shape<T>& shape);
+
     void computeConstants();  // Calculate A, B, C, D, N
 };
 
@@ -0,0 +1,145 @@
+// Dual.h
+// Dual numbers for forward-mode automatic differentiation
+// William Hopkins
+// October 2026
+//
+// A Dual<N> carries a value and its derivatives with respect to N
+// variables. Arithmetic and the functions below apply the chain rule, so a
+// function written as a template on its scalar type returns its derivatives
+// along with its value when called with Dual<N> arguments:
+//
+//   Dual<2> mean = Dual<2>::variable(0.0, 0), sigma = Dual<2>::variable(1.0, 1);
+//   Dual<2> f = exp(-0.5 * ((x - mean) / sigma) * ((x - mean) / sigma));
+//   // f.value is the value, f.d[0] = df/dmean, f.d[1] = df/dsigma
+//
+// Comparisons use the values only, so branches follow the value as they
+// would with plain doubles.
+
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <array>
+#include <cmath>
+
+template <int N>
+struct Dual {
+    double value = 0.0;
+    std::array<double, N> d{};  // derivatives with respect to each variable
+
+    Dual() = default;
+    Dual(double v) : value(v) {}
+
+    // Variable i of N, with derivative 1 with respect to itself
+    static Dual variable(double v, int i) {
+        Dual result(v);
+        result.d[i] = 1.0;
+        return result;
+    }
+
+    Dual& operator+=(const Dual& b) {
+        value += b.value;
+        for (int i = 0; i < N; i++) d[i] += b.d[i];
+        return *this;
+    }
+
+    // Result of a function g applied to this, given g and g' at value
+    Dual chain(double g, double slope) const {
+        Dual result(g);
+        for (int i = 0; i < N; i++) result.d[i] = slope * d[i];
+        return result;
+    }
+};
+
+template <int N>
+Dual<N> operator-(const Dual<N>& a) {
+    return a.chain(-a.value, -1.0);
+}
+
+template <int N>
+Dual<N> operator+(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> result(a.value + b.value);
+    for (int i = 0; i < N; i++) result.d[i] = a.d[i] + b.d[i];
+    return result;
+}
+
+template <int N>
+Dual<N> operator-(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> result(a.value - b.value);
+    for (int i = 0; i < N; i++) result.d[i] = a.d[i] - b.d[i];
+    return result;
+}
+
+template <int N>
+Dual<N> operator*(const Dual<N>& a, const Dual<N>& b) {
+    Dual<N> result(a.value * b.value);
+    for (int i = 0; i < N; i++) result.d[i] = a.d[i] * b.value + a.value * b.d[i];
+    return result;
+}
+
+template <int N>
+Dual<N> operator/(const Dual<N>& a, const Dual<N>& b) {
+    double inverse = 1.0 / b.value;
+    Dual<N> result(a.value * inverse);
+    for (int i = 0; i < N; i++) result.d[i] = (a.d[i] - result.value * b.d[i]) * inverse;
+    return result;
+}
+
+// Mixed with plain doubles, which are constants
+template <int N> Dual<N> operator+(const Dual<N>& a, double b) { return a.chain(a.value + b, 1.0); }
+template <int N> Dual<N> operator+(double a, const Dual<N>& b) { return b.chain(a + b.value, 1.0); }
+template <int N> Dual<N> operator-(const Dual<N>& a, double b) { return a.chain(a.value - b, 1.0); }
+template <int N> Dual<N> operator-(double a, const Dual<N>& b) { return b.chain(a - b.value, -1.0); }
+template <int N> Dual<N> operator*(const Dual<N>& a, double b) { return a.chain(a.value * b, b); }
+template <int N> Dual<N> operator*(double a, const Dual<N>& b) { return b.chain(a * b.value, a); }
+template <int N> Dual<N> operator/(const Dual<N>& a, double b) { return a.chain(a.value / b, 1.0 / b); }
+template <int N> Dual<N> operator/(double a, const Dual<N>& b) {
+    double value = a / b.value;
+    return b.chain(value, -value / b.value);
+}
+
+template <int N> bool operator<(const Dual<N>& a, const Dual<N>& b) { return a.value < b.value; }
+template <int N> bool operator>(const Dual<N>& a, const Dual<N>& b) { return a.value > b.value; }
+template <int N> bool operator<(const Dual<N>& a, double b) { return a.value < b; }
+template <int N> bool operator>(const Dual<N>& a, double b) { return a.value > b; }
+
+template <int N>
+Dual<N> exp(const Dual<N>& a) {
+    double value = std::exp(a.value);
+    return a.chain(value, value);
+}
+
+template <int N>
+Dual<N> log(const Dual<N>& a) {
+    return a.chain(std::log(a.value), 1.0 / a.value);
+}
+
+template <int N>
+Dual<N> sqrt(const Dual<N>& a) {
+    double value = std::sqrt(a.value);
+    return a.chain(value, 0.5 / value);
+}
+
+template <int N>
+Dual<N> fabs(const Dual<N>& a) {
+    return a.chain(std::fabs(a.value), (a.value < 0.0) ? -1.0 : 1.0);
+}
+
+// d/dx erf(x) = 2/sqrt(pi) exp(-x^2)
+template <int N>
+Dual<N> erf(const Dual<N>& a) {
+    return a.chain(std::erf(a.value), 1.1283791670955126 * std::exp(-a.value * a.value));
+}
+
+template <int N>
+Dual<N> pow(const Dual<N>& a, double b) {
+    double value = std::pow(a.value, b);
+    return a.chain(value, b * value / a.value);
+}
+
+// a^b = exp(b log a), for a > 0
+template <int N>
+Dual<N> pow(const Dual<N>& a, const Dual<N>& b) {
+    return exp(b * log(a));
+}
+
+#endif
@@ -0,0 +1,138 @@
+// FitDistributions.cxx
+// Fit each distribution to a MysteryData file by maximum likelihood, binned and unbinned
+// William Hopkins
+// October 2026
+
+#include "DataLoader.h"
+#include "Distributions.h"
+#include "LikelihoodFit.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cmath>
+#include <filesystem>
+
+// A minimiser, and whether it uses the function's exact gradient or finite
+// differences
+struct FitMethod {
+    MinimiserAlgorithm algorithm;
+    bool useGradient;
+};
+
+// Print a banner, fit function to data (binned, then unbinned with each
+// method, all from the same starting point) and plot the unbinned result.
+// With adaptive set, the unbinned fits normalise the function with the
+// adaptive Gauss-Kronrod integral instead of the 1000-step trapezoid rule.
+void fitAndPlot(const std::string& title, FiniteFunction& function, std::vector<double>& data,
+                int nThreads, int n_bins, const std::vector<FitMethod>& methods, bool adaptive) {
+    std::cout << "\n==================================================" << std::endl;
+    std::cout << "Fitting: " << title << std::endl;
+    std::cout << "==================================================" << std::endl;
+    std::vector<double> start = function.getParameters();
+    if (adaptive) function.setIntegrationMethod(IntegrationMethod::GaussKronrod, 1e-9, 2000);
+
+    BinnedFit binned(function, data, 100);
+    std::cout << "Binned Poisson likelihood (" << binned.bins() << " bins):" << std::endl;
+    binned.fit(methods.front().algorithm, methods.front().useGradient).print();
+
+    UnbinnedFit unbinned(function, data, nThreads);
+    for (const FitMethod& method : methods) {
+        function.setParameters(start);
+        std::cout << "Unbinned likelihood" << (method.useGradient ? "" : " (finite-difference gradient)") << ":"
+                  << std::endl;
+        unbinned.fit(method.algorithm, method.useGradient).print();
+    }
+    function.integral();
+    std::cout << "Normalisation integral: " << function.integralCalls() << " function calls";
+    if (adaptive) std::cout << ", error estimate " << function.integralError();
+    std::cout << std::endl;
+
+    function.plotFunction();
+    function.plotData(data, n_bins, true);
+}
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Maximum-Likelihood Distribution Fits" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    // Optional arguments: data file, number of threads for the likelihood,
+    // minimiser (migrad, bfgs, simplex, migrad-fd or bfgs-fd for finite
+    // differences in place of the exact gradient, or all to compare them) and
+    // normalisation integral (trapezoid or adaptive)
+    std::string datafile = (argc > 1) ? argv[1] : "../../../Data/MysteryData20000.txt";
+    int nThreads = (argc > 2) ? std::stoi(argv[2]) : 0;
+    std::string minimiser = (argc > 3) ? argv[3] : "migrad";
+    std::string integration = (argc > 4) ? argv[4] : "trapezoid";
+
+    std::vector<FitMethod> methods;
+    bool all = (minimiser == "all");
+    if (minimiser == "migrad" || all) methods.push_back({MinimiserAlgorithm::Migrad, true});
+    if (minimiser == "migrad-fd" || all) methods.push_back({MinimiserAlgorithm::Migrad, false});
+    if (minimiser == "bfgs" || all) methods.push_back({MinimiserAlgorithm::BFGS, true});
+    if (minimiser == "bfgs-fd" || all) methods.push_back({MinimiserAlgorithm::BFGS, false});
+    if (minimiser == "simplex" || all) methods.push_back({MinimiserAlgorithm::NelderMead, false});
+    if (methods.empty()) {
+        std::cerr << "Error: Unknown minimiser " << minimiser
+                  << " (use migrad, bfgs, simplex, migrad-fd, bfgs-fd or all)" << std::endl;
+        return 1;
+    }
+
+    if (integration != "trapezoid" && integration != "adaptive") {
+        std::cerr << "Error: Unknown integration " << integration << " (use trapezoid or adaptive)" << std::endl;
+        return 1;
+    }
+    bool adaptive = (integration == "adaptive");
+
+    if (!std::filesystem::exists("Plots")) {
+        std::filesystem::create_directories("Plots");
+    }
+
+    std::vector<double> mystery_data = readMysteryData(datafile, nThreads);
+    if (mystery_data.empty()) {
+        std::cerr << "No data loaded. Exiting." << std::endl;
+        return 1;
+    }
+
+    double range_min = -10.0;
+    double range_max = 10.0;
+    int n_bins = 50;
+
+    // Start every fit from the sample mean and RMS inside the range
+    double sum = 0.0, sum2 = 0.0;
+    long long count = 0;
+    for (double x : mystery_data) {
+        if (!(x >= range_min && x <= range_max)) continue;
+        sum += x;
+        sum2 += x * x;
+        count++;
+    }
+    if (count == 0) {
+        std::cerr << "Error: No data points in the fit range [" << range_min << ", " << range_max << "] in "
+                  << datafile << std::endl;
+        return 1;
+    }
+    double mean = sum / count;
+    double rms = std::sqrt(std::max(sum2 / count - mean * mean, 1e-6));
+    std::cout << "Starting values: mean = " << mean << ", RMS = " << rms << std::endl;
+
+    {
+        NormalDistribution normal(mean, rms, range_min, range_max, "NormalFit");
+        fitAndPlot("Normal Distribution", normal, mystery_data, nThreads, n_bins, methods, adaptive);
+    }
+    {
+        CauchyLorentzDistribution cauchy(mean, rms, range_min, range_max, "CauchyLorentzFit");
+        fitAndPlot("Cauchy-Lorentz Distribution", cauchy, mystery_data, nThreads, n_bins, methods, adaptive);
+    }
+    {
+        CrystalBallDistribution crystal(mean, rms, 1.5, 3.0, range_min, range_max, "CrystalBallFit");
+        fitAndPlot("Crystal Ball Distribution", crystal, mystery_data, nThreads, n_bins, methods, adaptive);
+    }
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "All fits complete!" << std::endl;
+    std::cout << "Check Plots/ for plots" << std::endl;
+    std::cout << "========================================" << std::endl;
+
+    return 0;
+}
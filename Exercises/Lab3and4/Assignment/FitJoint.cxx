@@ -0,0 +1,97 @@
+// FitJoint.cxx
+// Simultaneous fit to several MysteryData files with shared parameters
+// William Hopkins
+// October 2026
+
+#include "DataLoader.h"
+#include "LikelihoodFit.h"
+#include "ModelSelection.h"
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <memory>
+#include <filesystem>
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Joint Fit with Shared Parameters" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    // Optional arguments: number of threads, distribution (normal, cauchy or
+    // crystalball), comma-separated shared parameters, then the data files
+    int nThreads = (argc > 1) ? std::stoi(argv[1]) : 0;
+    std::string familyArgument = (argc > 2) ? argv[2] : "normal";
+    std::string sharedArgument = (argc > 3) ? argv[3] : "mean";
+    std::vector<std::string> files;
+    for (int i = 4; i < argc; i++) files.push_back(argv[i]);
+    if (files.empty()) {
+        for (const char* id : {"20000", "20123", "20202", "20212"}) {
+            files.push_back(std::string("../../../Data/MysteryData") + id + ".txt");
+        }
+    }
+
+    Family family;
+    if (familyArgument == "normal") family = Family::Normal;
+    else if (familyArgument == "cauchy") family = Family::CauchyLorentz;
+    else if (familyArgument == "crystalball") family = Family::CrystalBall;
+    else {
+        std::cerr << "Error: Unknown distribution " << familyArgument << " (use normal, cauchy or crystalball)"
+                  << std::endl;
+        return 1;
+    }
+
+    double range_min = -10.0;
+    double range_max = 10.0;
+
+    std::vector<std::vector<double>> data;
+    std::vector<std::string> labels;
+    for (const std::string& file : files) {
+        data.push_back(readMysteryData(file, nThreads, false));
+        if (data.back().empty()) {
+            std::cerr << "No data loaded from " << file << ". Exiting." << std::endl;
+            return 1;
+        }
+        std::string label = std::filesystem::path(file).stem().string();
+        if (label.rfind("MysteryData", 0) == 0) label = label.substr(11);
+        labels.push_back(label);
+    }
+
+    // Each file on its own, for comparison
+    std::cout << "Separate fits (" << familyName(family) << "):" << std::endl;
+    double separateSeconds = 0.0;
+    for (std::size_t d = 0; d < data.size(); d++) {
+        std::unique_ptr<FiniteFunction> function = makeFamily(family, data[d], range_min, range_max);
+        UnbinnedFit fitter(*function, data[d], nThreads);
+        FitResult result = fitter.fit();
+        separateSeconds += result.seconds;
+        std::cout << "  " << labels[d] << ":";
+        for (std::size_t i = 0; i < result.values.size(); i++) {
+            std::cout << " " << result.names[i] << " = " << result.values[i] << " +/- " << result.errors[i];
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "  " << separateSeconds << " s in total" << std::endl;
+
+    // One function per file, with the shared parameters tied together
+    std::vector<std::unique_ptr<FiniteFunction>> functions;
+    JointFit joint(nThreads);
+    for (std::size_t d = 0; d < data.size(); d++) {
+        functions.push_back(makeFamily(family, data[d], range_min, range_max));
+        joint.addDataset(*functions.back(), data[d], labels[d]);
+    }
+    std::stringstream shared(sharedArgument);
+    std::string name;
+    while (std::getline(shared, name, ',')) {
+        if (!name.empty() && !joint.share(name)) return 1;
+    }
+
+    std::cout << "\nJoint fit of " << joint.datasets() << " datasets, " << joint.nParameters()
+              << " parameters, shared: " << sharedArgument << std::endl;
+    FitResult result = joint.fit();
+    result.print();
+    std::cout << "  Dataset NLLs: " << joint.termEvaluations() << " computed, " << joint.termReuses()
+              << " reused because their parameters had not changed" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,578 @@
+// LikelihoodFit.cxx
+// William Hopkins
+// October 2026
+
+#include "LikelihoodFit.h"
+#include "Minimiser.h"
+#include <iostream>
+#include <iomanip>
+#include <future>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include <map>
+
+namespace {
+
+// Events per task. Large enough that a task costs far more than handing it
+// to the pool, small enough to spread 10^5 events over a few cores.
+const int eventBlock = 1 << 14;
+
+// Fill in errors from the covariance, or NaN if there is none
+void setErrors(FitResult& result) {
+    std::size_t n = result.values.size();
+    result.errors.assign(n, std::numeric_limits<double>::quiet_NaN());
+    if (result.covariance.size() != n * n) return;
+    for (std::size_t i = 0; i < n; i++) result.errors[i] = std::sqrt(result.covariance[i * n + i]);
+}
+
+// Finite-difference step for the Hessian: small next to the parameter, but
+// not so small that rounding in an NLL of order 10^5 dominates. Where a
+// bound is closer than that, the step is cut to half the distance, so both
+// sides stay valid (hessianCovariance copes with a parameter on its bound).
+std::vector<double> hessianSteps(const std::vector<double>& values, const ParameterBounds& bounds) {
+    std::vector<double> steps;
+    for (std::size_t i = 0; i < values.size(); i++) {
+        double step = 1e-3 * std::max(std::abs(values[i]), 0.1);
+        if (i < bounds.size()) {
+            double distance = std::min(values[i] - bounds[i].first, bounds[i].second - values[i]);
+            if (distance > 0.0) step = std::min(step, 0.5 * distance);
+        }
+        steps.push_back(step);
+    }
+    return steps;
+}
+
+// Minimise objective from initial, keeping each parameter inside its bounds,
+// and fill in the values, errors and call counts. Uses gradient, if it is
+// set, for the minimisation and the error estimate.
+void minimiseObjective(const std::vector<std::string>& names, const std::vector<double>& initial,
+                       const ParameterBounds& bounds, const Objective& objective, const ObjectiveGradient& gradient,
+                       MinimiserAlgorithm algorithm, FitResult& result) {
+    auto start = std::chrono::steady_clock::now();
+    result.names = names;
+
+    std::vector<double> steps;
+    for (double value : initial) steps.push_back(0.1 * std::max(std::abs(value), 0.1));
+
+    MinimiserResult minimum = minimise(objective, gradient, initial, steps, bounds, algorithm);
+    result.values = minimum.parameters;
+    result.nll = minimum.value;
+    result.calls = minimum.calls;
+    result.gradientCalls = minimum.gradientCalls;
+    result.iterations = minimum.iterations;
+    result.minimiser = minimiserName(algorithm);
+    result.converged = minimum.converged;
+
+    std::vector<double> h = hessianSteps(result.values, bounds);
+    if (gradient) result.covariance = hessianCovariance(gradient, result.values, h, result.errorCalls);
+    else result.covariance = hessianCovariance(objective, result.values, h, result.errorCalls);
+    (gradient ? result.gradientCalls : result.calls) += result.errorCalls;
+    setErrors(result);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    result.seconds = elapsed.count();
+}
+
+// Same, over the parameters of function, starting from its current ones and
+// leaving it at the best fit
+void minimiseObjective(FiniteFunction& function, const Objective& objective, const ObjectiveGradient& gradient,
+                       MinimiserAlgorithm algorithm, FitResult& result) {
+    ParameterBounds bounds;
+    for (int i = 0; i < function.nParameters(); i++) bounds.push_back(function.parameterBounds(i));
+    minimiseObjective(function.parameterNames(), function.getParameters(), bounds, objective, gradient, algorithm,
+                      result);
+    function.setParameters(result.values);
+}
+
+} // namespace
+
+void FitResult::print() const {
+    std::cout << std::setprecision(6);
+    for (std::size_t i = 0; i < values.size(); i++) {
+        std::cout << "  " << std::left << std::setw(8) << names[i] << std::right << " = " << values[i]
+                  << " +/- " << errors[i] << std::endl;
+    }
+    if (ndof > 0) {
+        std::cout << "  chi2/NDOF = " << chiSquared << " / " << ndof << " = " << chiSquared / ndof << " ("
+                  << events << " events)" << std::endl;
+    }
+    else {
+        std::cout << "  NLL = " << std::setprecision(10) << nll << std::setprecision(6) << " (" << events << " events)"
+                  << std::endl;
+    }
+    std::cout << "  " << minimiser << ": " << iterations << " iterations, " << calls << " likelihood";
+    if (gradientCalls > 0) std::cout << " + " << gradientCalls << " gradient";
+    std::cout << " evaluations (" << errorCalls << " for the errors) in " << seconds << " s"
+              << (converged ? "" : " - did NOT converge") << std::endl;
+    if (covariance.empty() && !values.empty()) {
+        std::cout << "  Hessian not positive definite: errors unavailable (a parameter is unconstrained by the data)"
+                  << std::endl;
+    }
+}
+
+UnbinnedFit::UnbinnedFit(FiniteFunction& function, const std::vector<double>& data, int nThreads,
+                         int integralDivisions)
+    : m_function(function), m_integralDivisions(integralDivisions) {
+    if (ThreadPool::workersFor(nThreads) > 1) m_pool = std::make_unique<ThreadPool>(nThreads);
+    double low = function.rangeMin(), high = function.rangeMax();
+    m_events.reserve(data.size());
+    for (double x : data) {
+        if (x >= low && x <= high) m_events.push_back(x);
+    }
+}
+
+double UnbinnedFit::sumLog() {
+    const int n = static_cast<int>(m_events.size());
+    const int nBlocks = (n + eventBlock - 1) / eventBlock;
+    auto block = [this, n](int b) {
+        int start = b * eventBlock;
+        return m_function.sumLogFunction(m_events.data() + start, std::min(eventBlock, n - start));
+    };
+
+    if (!m_pool || nBlocks <= 1) {
+        double sum = 0.0;
+        for (int b = 0; b < nBlocks; b++) sum += block(b);
+        return sum;
+    }
+
+    std::vector<std::future<double>> partials;
+    for (int b = 0; b < nBlocks; b++) partials.push_back(m_pool->submit([block, b]() { return block(b); }));
+    double sum = 0.0;
+    for (auto& partial : partials) sum += partial.get();
+    return sum;
+}
+
+double UnbinnedFit::sumLogGradient(std::vector<double>& gradient) {
+    const int n = static_cast<int>(m_events.size());
+    const int nBlocks = (n + eventBlock - 1) / eventBlock;
+    const std::size_t k = gradient.size();
+    std::vector<std::vector<double>> partialGradients(nBlocks, std::vector<double>(k, 0.0));
+    auto block = [this, n, &partialGradients](int b) {
+        int start = b * eventBlock;
+        return m_function.sumLogGradient(m_events.data() + start, std::min(eventBlock, n - start),
+                                         partialGradients[b].data());
+    };
+
+    double sum = 0.0;
+    if (!m_pool || nBlocks <= 1) {
+        for (int b = 0; b < nBlocks; b++) sum += block(b);
+    }
+    else {
+        std::vector<std::future<double>> partials;
+        for (int b = 0; b < nBlocks; b++) partials.push_back(m_pool->submit([block, b]() { return block(b); }));
+        for (auto& partial : partials) sum += partial.get();
+    }
+
+    // Blocks are added in order, as in sumLog
+    for (const std::vector<double>& partial : partialGradients) {
+        for (std::size_t j = 0; j < k; j++) gradient[j] += partial[j];
+    }
+    return sum;
+}
+
+double UnbinnedFit::nll(const std::vector<double>& params) {
+    m_function.setParameters(params);
+    double norm = m_function.integral(m_integralDivisions);
+    if (!(norm > 0.0) || !std::isfinite(norm)) return std::numeric_limits<double>::infinity();
+
+    double value = -sumLog() + static_cast<double>(m_events.size()) * std::log(norm);
+    return std::isfinite(value) ? value : std::numeric_limits<double>::infinity();
+}
+
+double UnbinnedFit::nllGradient(const std::vector<double>& params, std::vector<double>& gradient) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    m_function.setParameters(params);
+    gradient.assign(params.size(), 0.0);
+    std::vector<double> normGradient(params.size());
+    double norm = m_function.integralGradient(m_integralDivisions, normGradient.data());
+    if (!(norm > 0.0) || !std::isfinite(norm)) return infinity;
+
+    std::vector<double> logGradient(params.size(), 0.0);
+    const double events = static_cast<double>(m_events.size());
+    double value = -sumLogGradient(logGradient) + events * std::log(norm);
+    for (std::size_t j = 0; j < params.size(); j++) gradient[j] = -logGradient[j] + events * normGradient[j] / norm;
+    return std::isfinite(value) ? value : infinity;
+}
+
+FitResult UnbinnedFit::fit(MinimiserAlgorithm algorithm, bool useGradient) {
+    FitResult result;
+    result.events = events();
+    ObjectiveGradient gradient;
+    if (useGradient && m_function.hasGradient()) {
+        gradient = [this](const std::vector<double>& params, std::vector<double>& g) { return nllGradient(params, g); };
+    }
+    minimiseObjective(m_function, [this](const std::vector<double>& params) { return nll(params); }, gradient,
+                      algorithm, result);
+    return result;
+}
+
+JointFit::JointFit(int nThreads, int integralDivisions) : m_integralDivisions(integralDivisions) {
+    if (ThreadPool::workersFor(nThreads) > 1) m_pool = std::make_unique<ThreadPool>(nThreads);
+}
+
+int JointFit::addDataset(FiniteFunction& function, const std::vector<double>& data, const std::string& label) {
+    Term term;
+    term.function = &function;
+    term.fit = std::make_unique<UnbinnedFit>(function, data, 1, m_integralDivisions);
+    term.label = label;
+    for (int j = 0; j < function.nParameters(); j++) term.globals.push_back(nParameters() + j);
+    m_terms.push_back(std::move(term));
+    relabel();
+    return datasets() - 1;
+}
+
+bool JointFit::share(const std::string& name, const std::vector<int>& datasets) {
+    std::vector<int> chosen = datasets;
+    if (chosen.empty()) {
+        for (int d = 0; d < this->datasets(); d++) chosen.push_back(d);
+    }
+
+    std::vector<int> locals;
+    for (int d : chosen) {
+        if (d < 0 || d >= this->datasets()) {
+            std::cerr << "Error: No dataset " << d << " in the joint fit" << std::endl;
+            return false;
+        }
+        std::vector<std::string> names = m_terms[d].function->parameterNames();
+        auto found = std::find(names.begin(), names.end(), name);
+        if (found == names.end()) {
+            std::cerr << "Error: Dataset " << m_terms[d].label << " has no parameter " << name << std::endl;
+            return false;
+        }
+        locals.push_back(static_cast<int>(found - names.begin()));
+    }
+    if (chosen.empty()) return true;
+
+    int global = m_terms[chosen[0]].globals[locals[0]];
+    for (std::size_t k = 1; k < chosen.size(); k++) m_terms[chosen[k]].globals[locals[k]] = global;
+    relabel();
+    return true;
+}
+
+// Global parameters are numbered in order of first use. A parameter used by
+// one dataset is called name[label], one shared by every dataset name, and one
+// shared by some of them name[label,label,...].
+void JointFit::relabel() {
+    std::map<int, int> renumber;
+    for (Term& term : m_terms) {
+        for (int& global : term.globals) {
+            global = renumber.emplace(global, static_cast<int>(renumber.size())).first->second;
+        }
+    }
+
+    const int n = static_cast<int>(renumber.size());
+    std::vector<std::string> labels(n);
+    std::vector<int> owners(n, 0);
+    m_names.assign(n, "");
+    m_bounds.assign(n, {-std::numeric_limits<double>::infinity(), std::numeric_limits<double>::infinity()});
+    for (const Term& term : m_terms) {
+        std::vector<std::string> names = term.function->parameterNames();
+        for (std::size_t j = 0; j < term.globals.size(); j++) {
+            int g = term.globals[j];
+            if (owners[g]++ == 0) m_names[g] = names[j];
+            else labels[g] += ",";
+            labels[g] += term.label;
+            std::pair<double, double> bounds = term.function->parameterBounds(static_cast<int>(j));
+            m_bounds[g].first = std::max(m_bounds[g].first, bounds.first);
+            m_bounds[g].second = std::min(m_bounds[g].second, bounds.second);
+        }
+    }
+    for (int g = 0; g < n; g++) {
+        if (owners[g] < datasets()) m_names[g] += "[" + labels[g] + "]";
+    }
+}
+
+std::vector<double> JointFit::getParameters() const {
+    std::vector<double> values(nParameters(), 0.0);
+    std::vector<bool> set(nParameters(), false);
+    for (const Term& term : m_terms) {
+        std::vector<double> local = term.function->getParameters();
+        for (std::size_t j = 0; j < term.globals.size(); j++) {
+            if (set[term.globals[j]]) continue;
+            values[term.globals[j]] = local[j];
+            set[term.globals[j]] = true;
+        }
+    }
+    return values;
+}
+
+std::vector<int> JointFit::dependents(int i) const {
+    std::vector<int> result;
+    for (int d = 0; d < datasets(); d++) {
+        const std::vector<int>& globals = m_terms[d].globals;
+        if (std::find(globals.begin(), globals.end(), i) != globals.end()) result.push_back(d);
+    }
+    return result;
+}
+
+long long JointFit::events() const {
+    long long total = 0;
+    for (const Term& term : m_terms) total += term.fit->events();
+    return total;
+}
+
+std::vector<double> JointFit::localParameters(const Term& term, const std::vector<double>& params) const {
+    std::vector<double> local;
+    for (int global : term.globals) local.push_back(params[global]);
+    return local;
+}
+
+double JointFit::evaluate(const std::vector<double>& params, std::vector<double>* gradient) {
+    // Recompute only the datasets whose own parameters changed
+    std::vector<int> stale;
+    for (int d = 0; d < datasets(); d++) {
+        const Term& term = m_terms[d];
+        std::vector<double> local = localParameters(term, params);
+        bool cached = (term.gradientCacheValid && local == term.gradientParameters) ||
+                      (!gradient && term.cacheValid && local == term.cachedParameters);
+        if (cached) m_termReuses++;
+        else stale.push_back(d);
+    }
+    m_termEvaluations += static_cast<long long>(stale.size());
+
+    // Each task touches only its own term and function
+    auto update = [this, &params, gradient](int d) {
+        Term& term = m_terms[d];
+        std::vector<double> local = localParameters(term, params);
+        if (gradient) {
+            term.gradientValue = term.fit->nllGradient(local, term.cachedGradient);
+            term.gradientParameters = local;
+            term.gradientCacheValid = true;
+        }
+        else {
+            term.cachedValue = term.fit->nll(local);
+            term.cachedParameters = local;
+            term.cacheValid = true;
+        }
+    };
+    if (!m_pool || stale.size() <= 1) {
+        for (int d : stale) update(d);
+    }
+    else {
+        std::vector<std::future<void>> tasks;
+        for (int d : stale) tasks.push_back(m_pool->submit([update, d]() { update(d); }));
+        for (auto& task : tasks) task.get();
+    }
+
+    // Added in dataset order, so the sum does not depend on which terms were
+    // recomputed
+    if (gradient) gradient->assign(params.size(), 0.0);
+    double total = 0.0;
+    for (const Term& term : m_terms) {
+        std::vector<double> local = localParameters(term, params);
+        bool fromGradient = term.gradientCacheValid && local == term.gradientParameters;
+        total += fromGradient ? term.gradientValue : term.cachedValue;
+        if (!gradient) continue;
+        for (std::size_t j = 0; j < term.globals.size(); j++) (*gradient)[term.globals[j]] += term.cachedGradient[j];
+    }
+    return std::isfinite(total) ? total : std::numeric_limits<double>::infinity();
+}
+
+double JointFit::nll(const std::vector<double>& params) {
+    return evaluate(params, nullptr);
+}
+
+double JointFit::nllGradient(const std::vector<double>& params, std::vector<double>& gradient) {
+    return evaluate(params, &gradient);
+}
+
+FitResult JointFit::fit(MinimiserAlgorithm algorithm, bool useGradient) {
+    FitResult result;
+    result.events = events();
+    bool exact = useGradient && !m_terms.empty();
+    for (const Term& term : m_terms) exact = exact && term.function->hasGradient();
+
+    ObjectiveGradient gradient;
+    if (exact) {
+        gradient = [this](const std::vector<double>& params, std::vector<double>& g) { return nllGradient(params, g); };
+    }
+    Objective objective = [this](const std::vector<double>& params) { return nll(params); };
+    minimiseObjective(m_names, getParameters(), m_bounds, objective, gradient, algorithm, result);
+    for (Term& term : m_terms) term.function->setParameters(localParameters(term, result.values));
+    return result;
+}
+
+BinnedFit::BinnedFit(FiniteFunction& function, const std::vector<double>& data, int nBins,
+                     BinnedStatistic statistic, int panelsPerBin)
+    : m_function(function), m_statistic(statistic), m_panelsPerBin(std::max(panelsPerBin, 1)) {
+    setCounts(function.binData(data, nBins));
+}
+
+BinnedFit::BinnedFit(FiniteFunction& function, ValueStream& data, int nBins,
+                     BinnedStatistic statistic, int panelsPerBin)
+    : m_function(function), m_statistic(statistic), m_panelsPerBin(std::max(panelsPerBin, 1)) {
+    setCounts(function.binData(data, nBins));
+}
+
+void BinnedFit::setCounts(const std::vector<long long>& counts) {
+    m_counts.assign(counts.begin(), counts.end());
+    m_events = 0;
+    for (long long count : counts) m_events += count;
+}
+
+// Composite Simpson's rule over m_panelsPerBin panels per bin: the bin edges
+// and the panel edges and midpoints, with edges shared between neighbours
+std::vector<double> BinnedFit::samplePoints() const {
+    const double low = m_function.rangeMin();
+    const double h = (m_function.rangeMax() - low) / (bins() * m_panelsPerBin);
+    std::vector<double> points(2 * bins() * m_panelsPerBin + 1);
+    for (std::size_t j = 0; j < points.size(); j++) points[j] = low + j * 0.5 * h;
+    return points;
+}
+
+// Integral over one bin from values at the sample points, stride apart
+double BinnedFit::simpsonBin(const double* values, int bin, int stride) const {
+    const double h = (m_function.rangeMax() - m_function.rangeMin()) / (bins() * m_panelsPerBin);
+    double sum = 0.0;
+    for (int p = 0; p < m_panelsPerBin; p++) {
+        int j = 2 * (bin * m_panelsPerBin + p);
+        sum += values[j * stride] + 4.0 * values[(j + 1) * stride] + values[(j + 2) * stride];
+    }
+    return sum * h / 6.0;
+}
+
+const std::vector<double>& BinnedFit::binFractions(const std::vector<double>& params) {
+    if (m_cacheValid && params == m_cachedParameters) return m_binFractions;
+
+    m_function.setParameters(params);
+    m_cachedParameters = params;
+    m_cacheValid = true;
+    m_gradientCacheValid = false; // m_binFractions no longer matches m_gradientParameters
+    m_integralUpdates++;
+
+    std::vector<double> points = samplePoints();
+    std::vector<double> values(points.size());
+    for (std::size_t j = 0; j < points.size(); j++) values[j] = m_function.callFunction(points[j]);
+
+    m_binFractions.assign(bins(), 0.0);
+    double total = 0.0;
+    for (int b = 0; b < bins(); b++) {
+        m_binFractions[b] = simpsonBin(values.data(), b, 1);
+        total += m_binFractions[b];
+    }
+
+    if (!(total > 0.0) || !std::isfinite(total)) {
+        m_binFractions.clear();
+        return m_binFractions;
+    }
+    for (double& fraction : m_binFractions) fraction /= total;
+    return m_binFractions;
+}
+
+// Fractions F_b / T and their derivatives (dF_b - (F_b / T) dT) / T, from one
+// callFunctionGradient pass over the sample points
+bool BinnedFit::updateFractionGradients(const std::vector<double>& params) {
+    if (m_gradientCacheValid && params == m_gradientParameters) return !m_binFractions.empty();
+
+    m_function.setParameters(params);
+    m_gradientParameters = params;
+    m_gradientCacheValid = true;
+    m_cachedParameters = params;
+    m_cacheValid = true;
+    m_integralUpdates++;
+
+    const int k = static_cast<int>(params.size());
+    std::vector<double> points = samplePoints();
+    std::vector<double> values(points.size()), gradients(points.size() * k);
+    m_function.callFunctionGradient(points.data(), static_cast<int>(points.size()), values.data(), gradients.data());
+
+    m_binFractions.assign(bins(), 0.0);
+    m_fractionGradients.assign(bins() * k, 0.0);
+    double total = 0.0;
+    std::vector<double> totalGradient(k, 0.0);
+    for (int b = 0; b < bins(); b++) {
+        m_binFractions[b] = simpsonBin(values.data(), b, 1);
+        total += m_binFractions[b];
+        for (int j = 0; j < k; j++) {
+            m_fractionGradients[b * k + j] = simpsonBin(gradients.data() + j, b, k);
+            totalGradient[j] += m_fractionGradients[b * k + j];
+        }
+    }
+
+    if (!(total > 0.0) || !std::isfinite(total)) {
+        m_binFractions.clear();
+        return false;
+    }
+    for (int b = 0; b < bins(); b++) {
+        m_binFractions[b] /= total;
+        for (int j = 0; j < k; j++) {
+            double& derivative = m_fractionGradients[b * k + j];
+            derivative = (derivative - m_binFractions[b] * totalGradient[j]) / total;
+        }
+    }
+    return true;
+}
+
+std::vector<double> BinnedFit::expected(const std::vector<double>& params) {
+    std::vector<double> mu = binFractions(params);
+    for (double& value : mu) value *= static_cast<double>(m_events);
+    return mu;
+}
+
+double BinnedFit::objective(const std::vector<double>& params) {
+    const std::vector<double>& fractions = binFractions(params);
+    if (fractions.empty()) return std::numeric_limits<double>::infinity();
+    return statistic(fractions, nullptr);
+}
+
+double BinnedFit::objectiveGradient(const std::vector<double>& params, std::vector<double>& gradient) {
+    gradient.assign(params.size(), 0.0);
+    if (!updateFractionGradients(params)) return std::numeric_limits<double>::infinity();
+    return statistic(m_binFractions, &gradient);
+}
+
+double BinnedFit::statistic(const std::vector<double>& fractions, std::vector<double>* gradient) {
+    const double infinity = std::numeric_limits<double>::infinity();
+    const double events = static_cast<double>(m_events);
+    const std::size_t k = gradient ? gradient->size() : 0;
+
+    double chi2 = 0.0;
+    for (int b = 0; b < bins(); b++) {
+        double n = m_counts[b];
+        double mu = fractions[b] * events;
+        double slope = 0.0; // d(chi2) / d(mu)
+        if (m_statistic == BinnedStatistic::Poisson) {
+            if (mu < 0.0 || (mu == 0.0 && n > 0.0)) return infinity;
+            chi2 += 2.0 * (mu - n);
+            slope = 2.0;
+            if (n > 0.0) {
+                chi2 += 2.0 * n * std::log(n / mu);
+                slope -= 2.0 * n / mu;
+            }
+        }
+        else if (n > 0.0) {
+            chi2 += (n - mu) * (n - mu) / n;
+            slope = -2.0 * (n - mu) / n;
+        }
+        for (std::size_t j = 0; j < k; j++) (*gradient)[j] += 0.5 * slope * events * m_fractionGradients[b * k + j];
+    }
+    return std::isfinite(chi2) ? 0.5 * chi2 : infinity;
+}
+
+FitResult BinnedFit::fit(MinimiserAlgorithm algorithm, bool useGradient) {
+    FitResult result;
+    result.events = events();
+    ObjectiveGradient gradient;
+    if (useGradient && m_function.hasGradient()) {
+        gradient = [this](const std::vector<double>& params, std::vector<double>& g) {
+            return objectiveGradient(params, g);
+        };
+    }
+    minimiseObjective(m_function, [this](const std::vector<double>& params) { return objective(params); }, gradient,
+                      algorithm, result);
+    result.chiSquared = 2.0 * result.nll;
+    result.ndof = ndof(result.values.size());
+    return result;
+}
+
+long long BinnedFit::ndof(std::size_t nParameters) const {
+    // Empty bins carry no information in the Neyman chi-squared
+    long long usedBins = bins();
+    if (m_statistic == BinnedStatistic::ChiSquare) {
+        usedBins = std::count_if(m_counts.begin(), m_counts.end(), [](double n) { return n > 0.0; });
+    }
+    // The expected counts are scaled to the observed total, which fixes one bin
+    return usedBins - 1 - static_cast<long long>(nParameters);
+}
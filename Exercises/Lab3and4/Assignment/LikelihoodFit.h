@@ -0,0 +1,255 @@
+// LikelihoodFit.h
+// Maximum-likelihood fits of a FiniteFunction's parameters to data
+// William Hopkins
+// October 2026
+//
+// The function is normalised over its range [rangeMin, rangeMax] with
+// integral(), so the probability density of an event x is
+// f(x) / integral. Events outside the range are left out, as in plotData.
+// UnbinnedFit uses every event; BinnedFit fits the histogram of the events,
+// which costs O(bins) per step however many events there are.
+//
+//   NormalDistribution normal(-2.0, 1.0, -10.0, 10.0, "NormalFit");
+//   UnbinnedFit fitter(normal, data);
+//   FitResult result = fitter.fit();   // normal now holds the best fit
+//   result.print();
+//
+// When the function has exact parameter derivatives (hasGradient(), e.g. the
+// distributions through dual numbers) the fitters pass the minimiser the
+// gradient of the NLL as well, so it needs no finite differences.
+
+#ifndef LIKELIHOODFIT_H
+#define LIKELIHOODFIT_H
+
+#include "../FiniteFunctions.h"
+#include "DataStream.h"
+#include "ThreadPool.h"
+#include "Minimiser.h"
+#include <vector>
+#include <string>
+#include <memory>
+
+// Best-fit parameters with their uncertainties
+struct FitResult {
+    std::vector<std::string> names;
+    std::vector<double> values;
+    std::vector<double> errors;      // sqrt of the covariance diagonal (NaN if unavailable)
+    std::vector<double> covariance;  // n x n, row-major; empty if the Hessian was not positive definite
+    double nll = 0.0;                // objective at the minimum (NLL, or chi-squared / 2 when binned)
+    long long events = 0;            // events inside the function range
+    double chiSquared = 0.0;         // binned fits only: goodness of fit over ndof
+    long long ndof = 0;              // bins - 1 - parameters (0 for unbinned fits)
+    int calls = 0;                   // likelihood evaluations, including the error estimate
+    int gradientCalls = 0;           // likelihood gradient evaluations, including the error estimate
+    int errorCalls = 0;              // evaluations of either kind for the error estimate
+    int iterations = 0;              // minimiser iterations
+    std::string minimiser;           // algorithm used
+    double seconds = 0.0;            // wall time of the fit
+    bool converged = false;
+
+    void print() const;
+};
+
+// Unbinned negative log-likelihood
+//   NLL = -sum_i log f(x_i) + N log(integral)
+// The sum over events is the inner loop of every minimisation. It runs in
+// fixed blocks of events on a thread pool, with each block using the
+// function's sumLogFunction, and the block sums are added in block order, so
+// the NLL does not depend on the number of threads. With one thread there is
+// no pool and the blocks are summed inline.
+class UnbinnedFit {
+public:
+    // function must outlive the fitter; nThreads <= 0 uses one per core
+    UnbinnedFit(FiniteFunction& function, const std::vector<double>& data, int nThreads = 0,
+                int integralDivisions = 1000);
+
+    // NLL with the function's parameters set to params (+infinity where the
+    // function is not a valid density, e.g. a negative width)
+    double nll(const std::vector<double>& params);
+
+    // NLL with its gradient, from the function's sumLogGradient and
+    // integralGradient
+    double nllGradient(const std::vector<double>& params, std::vector<double>& gradient);
+
+    // Minimise the NLL starting from the function's current parameters, and
+    // estimate errors from the Hessian. Leaves the function at the best fit.
+    // Parameters are kept inside the function's parameterBounds. Set
+    // useGradient to false to use finite differences even when the function
+    // has a gradient.
+    FitResult fit(MinimiserAlgorithm algorithm = MinimiserAlgorithm::Migrad, bool useGradient = true);
+
+    long long events() const { return static_cast<long long>(m_events.size()); }
+
+private:
+    FiniteFunction& m_function;
+    std::vector<double> m_events;  // data inside the function range
+    std::unique_ptr<ThreadPool> m_pool; // nullptr on one thread, which sums inline
+    int m_integralDivisions;
+
+    double sumLog(); // sum of log f over every event
+    double sumLogGradient(std::vector<double>& gradient); // same, with its gradient
+};
+
+// Simultaneous unbinned fit to several datasets, each described by its own
+// function, with some parameters shared between datasets (e.g. one mean with
+// a width per dataset). The joint NLL is the sum of the datasets' NLLs:
+//   NLL(theta) = sum_d NLL_d(theta restricted to dataset d's parameters)
+// Each parameter of each function is either its own global parameter, named
+// "name[label]", or tied by share() to a global parameter, named "name", that
+// is used by several datasets.
+//
+// The datasets' terms are evaluated in parallel, one task per dataset. Each
+// term remembers the parameters of its last evaluation, so only the datasets
+// whose parameters changed are evaluated again. When the minimiser or the
+// error estimate moves one parameter at a time (finite differences), only the
+// datasets that use that parameter are recomputed; with exact gradients,
+// each dataset's gradient is added to the components it depends on.
+//
+//   JointFit joint;
+//   joint.addDataset(normalA, dataA, "A");
+//   joint.addDataset(normalB, dataB, "B");
+//   joint.share("mean");                     // parameters mean, sigma[A], sigma[B]
+//   joint.fit().print();
+class JointFit {
+public:
+    // nThreads <= 0 uses one per core. Each dataset is evaluated on one
+    // thread, by an UnbinnedFit without a pool of its own.
+    explicit JointFit(int nThreads = 0, int integralDivisions = 1000);
+
+    // Add a dataset described by function, which must outlive the fit.
+    // label tells its parameters apart. Returns the index of the dataset.
+    int addDataset(FiniteFunction& function, const std::vector<double>& data, const std::string& label);
+
+    // Tie the parameter called name in the given datasets (every dataset if
+    // empty) to one global parameter. It starts from the value in the first
+    // of them and is kept inside all of their bounds. Returns false, changing
+    // nothing, if one of the datasets has no such parameter.
+    bool share(const std::string& name, const std::vector<int>& datasets = {});
+
+    int nParameters() const { return static_cast<int>(m_names.size()); }
+    const std::vector<std::string>& parameterNames() const { return m_names; }
+    std::vector<double> getParameters() const; // from the functions' current parameters
+
+    // Datasets whose NLL depends on global parameter i
+    std::vector<int> dependents(int i) const;
+
+    // Joint NLL at the global parameters params, and with its gradient (from
+    // each function's exact gradient)
+    double nll(const std::vector<double>& params);
+    double nllGradient(const std::vector<double>& params, std::vector<double>& gradient);
+
+    // Minimise the joint NLL from the functions' current parameters and
+    // estimate errors from the Hessian. Leaves every function at the best
+    // fit. Uses exact gradients only if every function has them.
+    FitResult fit(MinimiserAlgorithm algorithm = MinimiserAlgorithm::Migrad, bool useGradient = true);
+
+    int datasets() const { return static_cast<int>(m_terms.size()); }
+    long long events() const;
+    long long termEvaluations() const { return m_termEvaluations; } // per-dataset NLLs computed
+    long long termReuses() const { return m_termReuses; }           // skipped as unchanged
+
+private:
+    // One dataset: its fitter, the global index of each of its function's
+    // parameters, and the result of its last evaluation
+    struct Term {
+        FiniteFunction* function = nullptr;
+        std::unique_ptr<UnbinnedFit> fit;
+        std::string label;
+        std::vector<int> globals;
+        std::vector<double> cachedParameters;
+        double cachedValue = 0.0;
+        bool cacheValid = false;
+        std::vector<double> gradientParameters;
+        std::vector<double> cachedGradient;
+        double gradientValue = 0.0;
+        bool gradientCacheValid = false;
+    };
+
+    std::vector<Term> m_terms;
+    std::vector<std::string> m_names;
+    ParameterBounds m_bounds;
+    std::unique_ptr<ThreadPool> m_pool; // nullptr on one thread, which evaluates the terms inline
+    int m_integralDivisions;
+    long long m_termEvaluations = 0;
+    long long m_termReuses = 0;
+
+    void relabel(); // renumber the global parameters and rebuild their names and bounds
+    std::vector<double> localParameters(const Term& term, const std::vector<double>& params) const;
+    double evaluate(const std::vector<double>& params, std::vector<double>* gradient);
+};
+
+// Which statistic BinnedFit minimises
+enum class BinnedStatistic {
+    Poisson,   // Poisson likelihood ratio: chi2 = 2 sum [mu - n + n log(n/mu)]
+    ChiSquare  // Neyman chi-squared: sum (n - mu)^2 / n over non-empty bins
+};
+
+// Binned fit. The data are binned once with FiniteFunction::binData (the
+// binning plotData uses), which keeps the same events as UnbinnedFit,
+// including any at rangeMax. The expected count in each bin is
+//   mu_i = N * (integral over bin i) / (integral over the range)
+// with the per-bin integrals from Simpson's rule over panelsPerBin panels.
+// The integrals are cached with the parameters they were computed for and
+// only recomputed when the parameters change.
+class BinnedFit {
+public:
+    BinnedFit(FiniteFunction& function, const std::vector<double>& data, int nBins = 100,
+              BinnedStatistic statistic = BinnedStatistic::Poisson, int panelsPerBin = 4);
+
+    // Bins the file block by block, so the data never has to fit in memory
+    BinnedFit(FiniteFunction& function, ValueStream& data, int nBins = 100,
+              BinnedStatistic statistic = BinnedStatistic::Poisson, int panelsPerBin = 4);
+
+    // chi-squared / 2 at params, which has the same curvature as an NLL
+    // (+infinity where the function is not a valid density)
+    double objective(const std::vector<double>& params);
+
+    // objective with its gradient, from the per-bin integrals of the
+    // function's parameter derivatives
+    double objectiveGradient(const std::vector<double>& params, std::vector<double>& gradient);
+
+    // Minimise starting from the function's current parameters, estimate
+    // errors from the Hessian and leave the function at the best fit
+    FitResult fit(MinimiserAlgorithm algorithm = MinimiserAlgorithm::Migrad, bool useGradient = true);
+
+    // Expected counts per bin at params
+    std::vector<double> expected(const std::vector<double>& params);
+
+    // Degrees of freedom of the statistic for a model with nParameters: the
+    // bins that enter it, less one for the normalisation to the observed
+    // total, less the parameters
+    long long ndof(std::size_t nParameters) const;
+
+    int bins() const { return static_cast<int>(m_counts.size()); }
+    long long events() const { return m_events; }
+    const std::vector<double>& counts() const { return m_counts; }
+    int integralUpdates() const { return m_integralUpdates; } // times the bin integrals were recomputed
+
+private:
+    FiniteFunction& m_function;
+    std::vector<double> m_counts;
+    long long m_events = 0;
+    BinnedStatistic m_statistic;
+    int m_panelsPerBin;
+
+    // Cache of the per-bin integrals, normalised to sum to 1, and their
+    // parameter derivatives (bins x parameters, row-major)
+    std::vector<double> m_cachedParameters;
+    std::vector<double> m_binFractions;
+    bool m_cacheValid = false;
+    std::vector<double> m_gradientParameters;
+    std::vector<double> m_fractionGradients;
+    bool m_gradientCacheValid = false;
+    int m_integralUpdates = 0;
+
+    void setCounts(const std::vector<long long>& counts);
+    std::vector<double> samplePoints() const; // where Simpson's rule evaluates the function
+    double simpsonBin(const double* values, int bin, int stride) const;
+    const std::vector<double>& binFractions(const std::vector<double>& params); // empty if invalid
+    bool updateFractionGradients(const std::vector<double>& params); // false if invalid
+
+    // chi-squared / 2 from the fractions, adding its gradient when asked for
+    double statistic(const std::vector<double>& fractions, std::vector<double>* gradient);
+};
+
+#endif
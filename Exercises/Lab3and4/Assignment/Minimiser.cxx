@@ -0,0 +1,601 @@
+// Minimiser.cxx
+// William Hopkins
+// October 2026
+
+#include "Minimiser.h"
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+
+namespace {
+
+// ---------- Bounds ----------
+
+// Maps bounded external parameters x to unbounded internal ones u
+class BoundsTransform {
+public:
+    BoundsTransform(const ParameterBounds& bounds, std::size_t n) : m_bounds(bounds) {
+        m_bounds.resize(n, std::make_pair(-INFINITY, INFINITY));
+    }
+
+    double toExternal(std::size_t i, double u) const {
+        auto [a, b] = m_bounds[i];
+        if (std::isfinite(a) && std::isfinite(b)) return a + (b - a) * (std::sin(u) + 1.0) / 2.0;
+        if (std::isfinite(a)) return a - 1.0 + std::sqrt(u * u + 1.0);
+        if (std::isfinite(b)) return b + 1.0 - std::sqrt(u * u + 1.0);
+        return u;
+    }
+
+    double toInternal(std::size_t i, double x) const {
+        auto [a, b] = m_bounds[i];
+        if (std::isfinite(a) && std::isfinite(b)) return std::asin(std::clamp(2.0 * (x - a) / (b - a) - 1.0, -1.0, 1.0));
+        if (std::isfinite(a)) return std::sqrt(std::max((x - a + 1.0) * (x - a + 1.0) - 1.0, 0.0));
+        if (std::isfinite(b)) return std::sqrt(std::max((b - x + 1.0) * (b - x + 1.0) - 1.0, 0.0));
+        return x;
+    }
+
+    // dx/du
+    double derivative(std::size_t i, double u) const {
+        auto [a, b] = m_bounds[i];
+        if (std::isfinite(a) && std::isfinite(b)) return (b - a) * std::cos(u) / 2.0;
+        if (std::isfinite(a)) return u / std::sqrt(u * u + 1.0);
+        if (std::isfinite(b)) return -u / std::sqrt(u * u + 1.0);
+        return 1.0;
+    }
+
+    std::vector<double> toExternal(const std::vector<double>& u) const {
+        std::vector<double> x(u.size());
+        for (std::size_t i = 0; i < u.size(); i++) x[i] = toExternal(i, u[i]);
+        return x;
+    }
+
+    std::vector<double> toInternal(const std::vector<double>& x) const {
+        std::vector<double> u(x.size());
+        for (std::size_t i = 0; i < x.size(); i++) u[i] = toInternal(i, x[i]);
+        return u;
+    }
+
+private:
+    ParameterBounds m_bounds;
+};
+
+// The objective in internal coordinates, counting its evaluations
+struct Problem {
+    const Objective& objective;
+    const ObjectiveGradient& analyticGradient; // may be empty
+    BoundsTransform transform;
+    int maxCalls;
+    int calls = 0;
+    int gradientCalls = 0;
+
+    double operator()(const std::vector<double>& u) {
+        calls++;
+        double value = objective(transform.toExternal(u));
+        return std::isnan(value) ? INFINITY : value;
+    }
+
+    // Analytic gradient with respect to u, by the chain rule through the
+    // bounds transform
+    void gradient(const std::vector<double>& u, std::vector<double>& g) {
+        gradientCalls++;
+        analyticGradient(transform.toExternal(u), g);
+        for (std::size_t i = 0; i < u.size(); i++) g[i] *= transform.derivative(i, u[i]);
+    }
+
+    bool hasGradient() const { return static_cast<bool>(analyticGradient); }
+    bool exhausted() const { return calls + gradientCalls >= maxCalls; }
+};
+
+using Matrix = std::vector<double>; // n x n, row-major
+
+double dot(const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for (std::size_t i = 0; i < a.size(); i++) sum += a[i] * b[i];
+    return sum;
+}
+
+std::vector<double> multiply(const Matrix& m, const std::vector<double>& v) {
+    std::size_t n = v.size();
+    std::vector<double> result(n, 0.0);
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < n; j++) result[i] += m[i * n + j] * v[j];
+    }
+    return result;
+}
+
+Matrix diagonal(const std::vector<double>& d) {
+    std::size_t n = d.size();
+    Matrix m(n * n, 0.0);
+    for (std::size_t i = 0; i < n; i++) m[i * n + i] = d[i];
+    return m;
+}
+
+// Gradient at u (where the objective is fu): the analytic one if there is
+// one, otherwise central differences with steps h. Finite differences also
+// give the diagonal second derivatives, if asked for. Falls back to a
+// one-sided difference where one side is rejected (+infinity).
+void gradient(Problem& f, const std::vector<double>& u, double fu, const std::vector<double>& h,
+              std::vector<double>& g, std::vector<double>* g2 = nullptr) {
+    std::size_t n = u.size();
+    g.assign(n, 0.0);
+    if (f.hasGradient() && !g2) {
+        f.gradient(u, g);
+        return;
+    }
+    if (g2) g2->assign(n, 0.0);
+    std::vector<double> point = u;
+    for (std::size_t i = 0; i < n; i++) {
+        point[i] = u[i] + h[i];
+        double plus = f(point);
+        point[i] = u[i] - h[i];
+        double minus = f(point);
+        point[i] = u[i];
+
+        if (std::isfinite(plus) && std::isfinite(minus)) g[i] = (plus - minus) / (2.0 * h[i]);
+        else if (std::isfinite(plus)) g[i] = (plus - fu) / h[i];
+        else if (std::isfinite(minus)) g[i] = (fu - minus) / h[i];
+        if (g2 && std::isfinite(plus) && std::isfinite(minus)) (*g2)[i] = (plus - 2.0 * fu + minus) / (h[i] * h[i]);
+    }
+}
+
+// ---------- Nelder-Mead ----------
+
+// One Nelder-Mead run with the standard coefficients (reflection 1,
+// expansion 2, contraction 1/2, shrink 1/2)
+void nelderMeadRun(Problem& f, std::vector<double>& u, double& value, const std::vector<double>& steps,
+                   double tolerance, bool& converged, int& iterations) {
+    const std::size_t n = u.size();
+    std::vector<std::vector<double>> simplex(n + 1, u);
+    std::vector<double> values(n + 1);
+    for (std::size_t i = 0; i < n; i++) simplex[i + 1][i] += steps[i];
+    for (std::size_t i = 0; i <= n; i++) values[i] = f(simplex[i]);
+
+    converged = false;
+    std::vector<std::size_t> order(n + 1);
+    while (true) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return values[a] < values[b]; });
+        std::size_t best = order[0], worst = order[n], secondWorst = order[n > 0 ? n - 1 : 0];
+
+        if (values[worst] - values[best] < tolerance) {
+            converged = true;
+            break;
+        }
+        if (f.exhausted()) break;
+        iterations++;
+
+        // Centroid of every point but the worst
+        std::vector<double> centroid(n, 0.0);
+        for (std::size_t i = 0; i <= n; i++) {
+            if (i == worst) continue;
+            for (std::size_t k = 0; k < n; k++) centroid[k] += simplex[i][k] / n;
+        }
+        auto along = [&](double coefficient) {
+            std::vector<double> point(n);
+            for (std::size_t k = 0; k < n; k++) point[k] = centroid[k] + coefficient * (simplex[worst][k] - centroid[k]);
+            return point;
+        };
+
+        std::vector<double> reflected = along(-1.0);
+        double reflectedValue = f(reflected);
+        if (reflectedValue < values[best]) {
+            std::vector<double> expanded = along(-2.0);
+            double expandedValue = f(expanded);
+            if (expandedValue < reflectedValue) {
+                simplex[worst] = expanded;
+                values[worst] = expandedValue;
+            } else {
+                simplex[worst] = reflected;
+                values[worst] = reflectedValue;
+            }
+            continue;
+        }
+        if (reflectedValue < values[secondWorst]) {
+            simplex[worst] = reflected;
+            values[worst] = reflectedValue;
+            continue;
+        }
+
+        // Contract towards the better of the worst and reflected points
+        bool outside = reflectedValue < values[worst];
+        std::vector<double> contracted = along(outside ? -0.5 : 0.5);
+        double contractedValue = f(contracted);
+        if (contractedValue < std::min(reflectedValue, values[worst])) {
+            simplex[worst] = contracted;
+            values[worst] = contractedValue;
+            continue;
+        }
+
+        // Shrink everything towards the best point
+        for (std::size_t i = 0; i <= n; i++) {
+            if (i == best) continue;
+            for (std::size_t k = 0; k < n; k++) simplex[i][k] = simplex[best][k] + 0.5 * (simplex[i][k] - simplex[best][k]);
+            values[i] = f(simplex[i]);
+        }
+    }
+
+    std::size_t best = std::min_element(values.begin(), values.end()) - values.begin();
+    u = simplex[best];
+    value = values[best];
+}
+
+// Two runs: the second restarts from the best point with a smaller simplex,
+// in case the first collapsed early
+void nelderMead(Problem& f, std::vector<double> steps, double tolerance, MinimiserResult& result,
+                std::vector<double>& u) {
+    bool firstConverged = false, secondConverged = false;
+    double value = 0.0;
+    nelderMeadRun(f, u, value, steps, tolerance, firstConverged, result.iterations);
+
+    for (double& step : steps) step *= 0.1;
+    std::vector<double> restart = u;
+    double restartValue = 0.0;
+    nelderMeadRun(f, restart, restartValue, steps, tolerance, secondConverged, result.iterations);
+    if (restartValue < value) {
+        u = restart;
+        value = restartValue;
+    }
+    result.value = value;
+    result.converged = firstConverged && secondConverged;
+}
+
+// ---------- BFGS ----------
+
+void bfgs(Problem& f, const std::vector<double>& steps, double tolerance, MinimiserResult& result,
+          std::vector<double>& u) {
+    const std::size_t n = u.size();
+    std::vector<double> h(n), g, gNew;
+    for (std::size_t i = 0; i < n; i++) h[i] = 1e-3 * steps[i];
+
+    std::vector<double> squares(n);
+    for (std::size_t i = 0; i < n; i++) squares[i] = steps[i] * steps[i];
+    Matrix H = diagonal(squares); // inverse Hessian estimate
+    bool fresh = true;            // H is still the starting matrix
+
+    double fu = f(u);
+    gradient(f, u, fu, h, g);
+    while (!f.exhausted()) {
+        result.edm = 0.5 * dot(g, multiply(H, g));
+        if (result.edm < tolerance) {
+            result.converged = true;
+            break;
+        }
+        result.iterations++;
+
+        std::vector<double> p = multiply(H, g);
+        for (double& component : p) component = -component;
+        double slope = dot(g, p);
+        if (fresh) {
+            // Limit the first step to about one step size per parameter
+            double largest = 0.0;
+            for (std::size_t i = 0; i < n; i++) largest = std::max(largest, std::abs(p[i]) / steps[i]);
+            if (largest > 1.0) {
+                for (double& component : p) component /= largest;
+                slope /= largest;
+            }
+        }
+
+        // Backtracking line search with the Armijo condition, shrinking by
+        // quadratic interpolation
+        double alpha = 1.0, fNew = INFINITY;
+        std::vector<double> uNew(n);
+        bool found = false;
+        for (int tries = 0; tries < 40 && !f.exhausted(); tries++) {
+            for (std::size_t i = 0; i < n; i++) uNew[i] = u[i] + alpha * p[i];
+            fNew = f(uNew);
+            if (fNew <= fu + 1e-4 * alpha * slope) {
+                found = true;
+                break;
+            }
+            double next = std::isfinite(fNew) ? -slope * alpha * alpha / (2.0 * (fNew - fu - slope * alpha)) : 0.0;
+            alpha = std::clamp(next, 0.1 * alpha, 0.5 * alpha);
+        }
+
+        if (!found) {
+            if (fresh) break; // no progress even along the scaled gradient
+            H = diagonal(squares);
+            fresh = true;
+            continue;
+        }
+
+        gradient(f, uNew, fNew, h, gNew);
+        std::vector<double> s(n), y(n);
+        for (std::size_t i = 0; i < n; i++) {
+            s[i] = uNew[i] - u[i];
+            y[i] = gNew[i] - g[i];
+        }
+        double sy = dot(s, y);
+        if (sy > 1e-12 * std::sqrt(dot(s, s) * dot(y, y))) {
+            // Rescale the starting matrix before the first update
+            if (fresh) {
+                std::vector<double> scale(n, sy / dot(y, y));
+                H = diagonal(scale);
+                fresh = false;
+            }
+            // H = (I - rho s y^T) H (I - rho y s^T) + rho s s^T
+            double rho = 1.0 / sy;
+            std::vector<double> Hy = multiply(H, y);
+            double yHy = dot(y, Hy);
+            for (std::size_t i = 0; i < n; i++) {
+                for (std::size_t j = 0; j < n; j++) {
+                    H[i * n + j] += -rho * (s[i] * Hy[j] + Hy[i] * s[j]) + (rho * rho * yHy + rho) * s[i] * s[j];
+                }
+            }
+        }
+        u = uNew;
+        fu = fNew;
+        g = gNew;
+    }
+    result.value = fu;
+}
+
+// ---------- MIGRAD-like variable metric ----------
+
+void migrad(Problem& f, const std::vector<double>& steps, double tolerance, MinimiserResult& result,
+            std::vector<double>& u) {
+    const std::size_t n = u.size();
+    std::vector<double> g, g2, gNew;
+    double fu = f(u);
+
+    // Seed the metric with the inverse of the diagonal second derivatives
+    auto seed = [&]() {
+        std::vector<double> h(n);
+        for (std::size_t i = 0; i < n; i++) h[i] = 1e-3 * steps[i];
+        gradient(f, u, fu, h, g, &g2);
+        std::vector<double> inverse(n);
+        for (std::size_t i = 0; i < n; i++) inverse[i] = (g2[i] > 0.0) ? 1.0 / g2[i] : steps[i] * steps[i];
+        return diagonal(inverse);
+    };
+    Matrix V = seed();
+    bool reseeded = false;
+
+    // Gradient steps track the current error estimate, sqrt(V_ii)
+    auto gradientSteps = [&]() {
+        std::vector<double> h(n);
+        for (std::size_t i = 0; i < n; i++) {
+            double error = std::sqrt(std::max(V[i * n + i], 0.0));
+            h[i] = std::clamp(0.02 * error, 1e-8 * (1.0 + std::abs(u[i])), steps[i]);
+        }
+        return h;
+    };
+
+    while (!f.exhausted()) {
+        result.edm = 0.5 * dot(g, multiply(V, g));
+        if (result.edm < tolerance) {
+            result.converged = true;
+            break;
+        }
+        result.iterations++;
+
+        std::vector<double> p = multiply(V, g);
+        for (double& component : p) component = -component;
+        double slope = dot(g, p);
+        if (!(slope < 0.0)) {
+            if (reseeded) break;
+            V = seed();
+            reseeded = true;
+            continue;
+        }
+
+        // Parabolic line search: try the full step, then the minimum of the
+        // parabola through f(0), f'(0) and the last trial
+        double alpha = 1.0, fNew = INFINITY, bestAlpha = 0.0, bestValue = fu;
+        std::vector<double> uNew(n);
+        auto trial = [&](double a) {
+            for (std::size_t i = 0; i < n; i++) uNew[i] = u[i] + a * p[i];
+            double value = f(uNew);
+            if (value < bestValue) {
+                bestValue = value;
+                bestAlpha = a;
+            }
+            return value;
+        };
+        for (int tries = 0; tries < 12 && !f.exhausted(); tries++) {
+            fNew = trial(alpha);
+            double curvature = fNew - fu - slope * alpha;
+            double next = (std::isfinite(fNew) && curvature > 0.0) ? -slope * alpha * alpha / (2.0 * curvature) : 0.1 * alpha;
+            if (bestAlpha > 0.0) {
+                // Refine once around an improving step, then stop
+                if (std::abs(next - alpha) > 0.05 * alpha && next > 0.0 && next < 4.0 * alpha) trial(next);
+                break;
+            }
+            alpha = std::max(next, 0.1 * alpha);
+        }
+
+        if (bestAlpha == 0.0) {
+            if (reseeded) break;
+            V = seed();
+            reseeded = true;
+            continue;
+        }
+        reseeded = false;
+
+        for (std::size_t i = 0; i < n; i++) uNew[i] = u[i] + bestAlpha * p[i];
+        gradient(f, uNew, bestValue, gradientSteps(), gNew);
+
+        // Davidon-Fletcher-Powell update, with the BFGS term added when
+        // s.y > y.V.y (Fletcher's switching rule, as in MINUIT)
+        std::vector<double> s(n), y(n);
+        for (std::size_t i = 0; i < n; i++) {
+            s[i] = uNew[i] - u[i];
+            y[i] = gNew[i] - g[i];
+        }
+        double delta = dot(s, y);
+        std::vector<double> Vy = multiply(V, y);
+        double gamma = dot(y, Vy);
+        if (delta > 0.0 && gamma > 0.0) {
+            for (std::size_t i = 0; i < n; i++) {
+                for (std::size_t j = 0; j < n; j++) {
+                    V[i * n + j] += s[i] * s[j] / delta - Vy[i] * Vy[j] / gamma;
+                }
+            }
+            if (delta > gamma) {
+                std::vector<double> w(n);
+                for (std::size_t i = 0; i < n; i++) w[i] = s[i] / delta - Vy[i] / gamma;
+                for (std::size_t i = 0; i < n; i++) {
+                    for (std::size_t j = 0; j < n; j++) V[i * n + j] += gamma * w[i] * w[j];
+                }
+            }
+        }
+        u = uNew;
+        fu = bestValue;
+        g = gNew;
+    }
+    result.value = fu;
+}
+
+// In-place Cholesky decomposition of the n x n row-major matrix a
+bool choleskyDecompose(std::vector<double>& a, std::size_t n) {
+    for (std::size_t j = 0; j < n; j++) {
+        double diagonal = a[j * n + j];
+        for (std::size_t k = 0; k < j; k++) diagonal -= a[j * n + k] * a[j * n + k];
+        if (!(diagonal > 0.0)) return false;
+        double ljj = std::sqrt(diagonal);
+        a[j * n + j] = ljj;
+        for (std::size_t i = j + 1; i < n; i++) {
+            double sum = a[i * n + j];
+            for (std::size_t k = 0; k < j; k++) sum -= a[i * n + k] * a[j * n + k];
+            a[i * n + j] = sum / ljj;
+        }
+    }
+    return true;
+}
+
+// Covariance = H^-1 of the n x n Hessian, from its Cholesky factor one column
+// at a time. Empty if H is not positive definite.
+std::vector<double> invertHessian(std::vector<double> hessian, std::size_t n) {
+    // A rejected point (+infinity) in the differences leaves no usable Hessian
+    if (!std::all_of(hessian.begin(), hessian.end(), [](double value) { return std::isfinite(value); })) return {};
+    if (!choleskyDecompose(hessian, n)) return {};
+    std::vector<double> covariance(n * n, 0.0);
+    for (std::size_t column = 0; column < n; column++) {
+        std::vector<double> b(n, 0.0);
+        b[column] = 1.0;
+        for (std::size_t i = 0; i < n; i++) {
+            for (std::size_t k = 0; k < i; k++) b[i] -= hessian[i * n + k] * b[k];
+            b[i] /= hessian[i * n + i];
+        }
+        for (std::size_t i = n; i-- > 0;) {
+            for (std::size_t k = i + 1; k < n; k++) b[i] -= hessian[k * n + i] * b[k];
+            b[i] /= hessian[i * n + i];
+        }
+        for (std::size_t i = 0; i < n; i++) covariance[i * n + column] = b[i];
+    }
+    return covariance;
+}
+
+} // namespace
+
+const char* minimiserName(MinimiserAlgorithm algorithm) {
+    switch (algorithm) {
+        case MinimiserAlgorithm::NelderMead: return "Nelder-Mead";
+        case MinimiserAlgorithm::BFGS: return "BFGS";
+        default: return "Migrad";
+    }
+}
+
+MinimiserResult minimise(const Objective& objective, const std::vector<double>& start,
+                         const std::vector<double>& steps, const ParameterBounds& bounds,
+                         MinimiserAlgorithm algorithm, double tolerance, int maxCalls) {
+    return minimise(objective, nullptr, start, steps, bounds, algorithm, tolerance, maxCalls);
+}
+
+MinimiserResult minimise(const Objective& objective, const ObjectiveGradient& gradient,
+                         const std::vector<double>& start, const std::vector<double>& steps,
+                         const ParameterBounds& bounds, MinimiserAlgorithm algorithm, double tolerance,
+                         int maxCalls) {
+    auto begin = std::chrono::steady_clock::now();
+    const std::size_t n = start.size();
+    Problem f{objective, gradient, BoundsTransform(bounds, n), maxCalls};
+
+    // Starting point and step sizes in internal coordinates
+    std::vector<double> u = f.transform.toInternal(start);
+    std::vector<double> internalSteps(n);
+    for (std::size_t i = 0; i < n; i++) {
+        double slope = std::abs(f.transform.derivative(i, u[i]));
+        internalSteps[i] = std::min(steps[i] / std::max(slope, 1e-3), 1e3 * steps[i]);
+    }
+
+    MinimiserResult result;
+    result.algorithm = algorithm;
+    if (algorithm == MinimiserAlgorithm::NelderMead) nelderMead(f, internalSteps, tolerance, result, u);
+    else if (algorithm == MinimiserAlgorithm::BFGS) bfgs(f, internalSteps, tolerance, result, u);
+    else migrad(f, internalSteps, tolerance, result, u);
+
+    result.parameters = f.transform.toExternal(u);
+    result.calls = f.calls;
+    result.gradientCalls = f.gradientCalls;
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+    result.seconds = elapsed.count();
+    return result;
+}
+
+std::vector<double> hessianCovariance(const Objective& objective, const std::vector<double>& minimum,
+                                      const std::vector<double>& h, int& calls) {
+    const std::size_t n = minimum.size();
+    std::vector<double> hessian(n * n, 0.0);
+
+    auto at = [&](std::size_t i, double di, std::size_t j, double dj) {
+        std::vector<double> point = minimum;
+        point[i] += di;
+        point[j] += dj;
+        calls++;
+        return objective(point);
+    };
+
+    calls++;
+    double centre = objective(minimum);
+    for (std::size_t i = 0; i < n; i++) {
+        hessian[i * n + i] = (at(i, h[i], i, 0.0) - 2.0 * centre + at(i, -h[i], i, 0.0)) / (h[i] * h[i]);
+        for (std::size_t j = 0; j < i; j++) {
+            double value = (at(i, h[i], j, h[j]) - at(i, h[i], j, -h[j]) - at(i, -h[i], j, h[j]) +
+                            at(i, -h[i], j, -h[j])) / (4.0 * h[i] * h[j]);
+            hessian[i * n + j] = hessian[j * n + i] = value;
+        }
+    }
+
+    return invertHessian(hessian, n);
+}
+
+std::vector<double> hessianCovariance(const ObjectiveGradient& gradient, const std::vector<double>& minimum,
+                                      const std::vector<double>& h, int& calls) {
+    const std::size_t n = minimum.size();
+    std::vector<double> hessian(n * n, 0.0), plus(n), minus(n), centre;
+
+    // Gradient at point, or false if it is rejected (e.g. across a bound)
+    auto evaluate = [&](const std::vector<double>& point, std::vector<double>& g) {
+        calls++;
+        if (!std::isfinite(gradient(point, g))) return false;
+        return std::all_of(g.begin(), g.end(), [](double value) { return std::isfinite(value); });
+    };
+
+    for (std::size_t i = 0; i < n; i++) {
+        // Central difference, or a one-sided one from the minimum where one
+        // side is rejected. If both are, halve the step and try again.
+        std::vector<double> point = minimum;
+        bool done = false;
+        double step = h[i];
+        for (int attempt = 0; attempt < 10 && !done; attempt++, step *= 0.5) {
+            point[i] = minimum[i] + step;
+            bool plusValid = evaluate(point, plus);
+            point[i] = minimum[i] - step;
+            bool minusValid = evaluate(point, minus);
+            if (plusValid != minusValid && centre.empty() && !evaluate(minimum, centre)) return {};
+
+            for (std::size_t j = 0; j < n; j++) {
+                if (plusValid && minusValid) hessian[i * n + j] = (plus[j] - minus[j]) / (2.0 * step);
+                else if (plusValid) hessian[i * n + j] = (plus[j] - centre[j]) / step;
+                else if (minusValid) hessian[i * n + j] = (centre[j] - minus[j]) / step;
+            }
+            done = plusValid || minusValid;
+        }
+        if (!done) return {};
+    }
+    for (std::size_t i = 0; i < n; i++) {
+        for (std::size_t j = 0; j < i; j++) {
+            hessian[i * n + j] = hessian[j * n + i] = 0.5 * (hessian[i * n + j] + hessian[j * n + i]);
+        }
+    }
+    return invertHessian(hessian, n);
+}
@@ -0,0 +1,88 @@
+// Minimiser.h
+// Minimisers and error estimation for the fitters
+// William Hopkins
+// October 2026
+//
+// Three algorithms share one interface:
+//   NelderMead - simplex search, uses function values only
+//   BFGS       - quasi-Newton with the BFGS update and a backtracking line
+//                search, starting from a scaled identity matrix
+//   Migrad     - variable-metric method in the style of MINUIT's MIGRAD:
+//                seeded with numerical second derivatives, DFP/BFGS
+//                (Fletcher switching) updates, parabolic line search, and
+//                stopping on the estimated distance to the minimum (EDM)
+// Gradients come from central differences, or from the caller when an
+// ObjectiveGradient is given (e.g. from dual numbers, Dual.h), which saves
+// 2 evaluations per parameter at every step. Bounded parameters are mapped to
+// unbounded internal ones (x = a + (b - a)(sin u + 1)/2 for two bounds,
+// x = a - 1 + sqrt(u^2 + 1) for a lower bound only) so every algorithm
+// works without constraints.
+
+#ifndef MINIMISER_H
+#define MINIMISER_H
+
+#include <vector>
+#include <functional>
+#include <utility>
+
+// Function of the parameter vector to be minimised
+using Objective = std::function<double(const std::vector<double>&)>;
+
+// Objective value at the parameters, with its gradient written to the
+// second argument
+using ObjectiveGradient = std::function<double(const std::vector<double>&, std::vector<double>&)>;
+
+// (low, high) for each parameter, +-infinity where there is no bound. An
+// empty vector means no parameter is bounded.
+using ParameterBounds = std::vector<std::pair<double, double>>;
+
+enum class MinimiserAlgorithm { NelderMead, BFGS, Migrad };
+
+const char* minimiserName(MinimiserAlgorithm algorithm);
+
+struct MinimiserResult {
+    std::vector<double> parameters; // position of the minimum
+    double value = 0.0;             // objective at the minimum
+    double edm = 0.0;               // estimated distance to minimum (gradient methods)
+    int calls = 0;                  // objective evaluations
+    int gradientCalls = 0;          // ObjectiveGradient evaluations
+    int iterations = 0;
+    double seconds = 0.0;           // wall time
+    bool converged = false;         // false if maxCalls was reached first
+    MinimiserAlgorithm algorithm = MinimiserAlgorithm::Migrad;
+};
+
+// Minimise objective from start. steps give the initial scale of each
+// parameter (the first simplex for Nelder-Mead, the first step otherwise).
+// Stops when the simplex spread (Nelder-Mead) or the EDM falls below
+// tolerance, in units of the objective. The objective may return +infinity
+// to reject a point (e.g. a negative width).
+MinimiserResult minimise(const Objective& objective, const std::vector<double>& start,
+                         const std::vector<double>& steps, const ParameterBounds& bounds = {},
+                         MinimiserAlgorithm algorithm = MinimiserAlgorithm::Migrad,
+                         double tolerance = 1e-6, int maxCalls = 20000);
+
+// Same, with the gradient-based algorithms using gradient in place of finite
+// differences. Nelder-Mead ignores it.
+MinimiserResult minimise(const Objective& objective, const ObjectiveGradient& gradient,
+                         const std::vector<double>& start, const std::vector<double>& steps,
+                         const ParameterBounds& bounds = {},
+                         MinimiserAlgorithm algorithm = MinimiserAlgorithm::Migrad,
+                         double tolerance = 1e-6, int maxCalls = 20000);
+
+// Inverse of the Hessian of objective at minimum, from central differences
+// with steps h. For a negative log-likelihood this is the covariance matrix
+// of the parameters (n x n, row-major). Returns an empty vector if the
+// Hessian is not positive definite. calls is increased by the evaluations used.
+std::vector<double> hessianCovariance(const Objective& objective, const std::vector<double>& minimum,
+                                      const std::vector<double>& h, int& calls);
+
+// Same, from central differences of the gradient: 2 gradient evaluations
+// per parameter instead of about 2 n^2 objective evaluations. Where the
+// gradient is rejected (+infinity) on one side, e.g. across a bound, a
+// one-sided difference from the minimum is used; where both sides are, the
+// step is halved. Returns an empty vector if no step works.
+std::vector<double> hessianCovariance(const ObjectiveGradient& gradient, const std::vector<double>& minimum,
+                                      const std::vector<double>& h, int& calls);
+
+#endif
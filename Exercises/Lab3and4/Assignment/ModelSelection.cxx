@@ -0,0 +1,254 @@
+// ModelSelection.cxx
+// William Hopkins
+// October 2026
+
+#include "ModelSelection.h"
+#include "Distributions.h"
+#include "ThreadPool.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <numeric>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// Relative cost of fitting each family, for ordering the tasks (per-event
+// NLL cost times a typical number of iterations)
+double familyCost(Family family) {
+    switch (family) {
+        case Family::Normal: return 1.0;
+        case Family::CauchyLorentz: return 4.0;
+        default: return 40.0;
+    }
+}
+
+// "name=value+-error,..." for the table file
+std::string parameterList(const FitResult& fit) {
+    std::ostringstream text;
+    text << std::setprecision(6);
+    for (std::size_t i = 0; i < fit.values.size(); i++) {
+        if (i > 0) text << ",";
+        text << fit.names[i] << "=" << fit.values[i] << "+-" << fit.errors[i];
+    }
+    return text.str();
+}
+
+} // namespace
+
+const char* familyName(Family family) {
+    switch (family) {
+        case Family::Normal: return "Normal";
+        case Family::CauchyLorentz: return "CauchyLorentz";
+        default: return "CrystalBall";
+    }
+}
+
+std::unique_ptr<FiniteFunction> makeFamily(Family family, const std::vector<double>& data, double low, double high) {
+    double sum = 0.0, sum2 = 0.0;
+    long long count = 0;
+    for (double x : data) {
+        if (x < low || x > high) continue;
+        sum += x;
+        sum2 += x * x;
+        count++;
+    }
+    double mean = (count > 0) ? sum / count : 0.5 * (low + high);
+    double rms = (count > 0) ? std::sqrt(std::max(sum2 / count - mean * mean, 1e-6)) : 1.0;
+
+    std::string name = std::string(familyName(family)) + "Fit";
+    switch (family) {
+        case Family::Normal:
+            return std::make_unique<NormalDistribution>(mean, rms, low, high, name);
+        case Family::CauchyLorentz:
+            return std::make_unique<CauchyLorentzDistribution>(mean, rms, low, high, name);
+        default:
+            return std::make_unique<CrystalBallDistribution>(mean, rms, 1.5, 3.0, low, high, name);
+    }
+}
+
+double chiSquaredPValue(double chiSquared, long long ndof) {
+    if (ndof <= 0 || !std::isfinite(chiSquared)) return std::numeric_limits<double>::quiet_NaN();
+    // (chi2 / ndof)^(1/3) is close to normal with mean 1 - 2/(9 ndof) and
+    // variance 2/(9 ndof)
+    double k = static_cast<double>(ndof);
+    double variance = 2.0 / (9.0 * k);
+    double z = (std::cbrt(chiSquared / k) - (1.0 - variance)) / std::sqrt(variance);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+ModelSelection::ModelSelection(SelectionOptions options) : m_options(std::move(options)) {}
+
+void ModelSelection::run(const DataCatalog& catalog) {
+    auto start = std::chrono::steady_clock::now();
+
+    m_fits.clear();
+    std::vector<const Dataset*> datasets;
+    for (const std::string& id : catalog.ids()) {
+        const Dataset* dataset = catalog.find(id);
+        if (!dataset || !dataset->error.empty() || dataset->values.empty()) continue;
+        datasets.push_back(dataset);
+        for (Family family : m_options.families) {
+            ModelFit fit;
+            fit.dataset = id;
+            fit.family = family;
+            m_fits.push_back(fit);
+        }
+    }
+
+    // Longest tasks first, so the pool does not finish on one slow fit
+    const std::size_t nFamilies = m_options.families.size();
+    std::vector<std::size_t> order(m_fits.size());
+    std::iota(order.begin(), order.end(), 0);
+    auto cost = [&](std::size_t i) {
+        return familyCost(m_fits[i].family) * static_cast<double>(datasets[i / nFamilies]->values.size());
+    };
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return cost(a) > cost(b); });
+
+    {
+        ThreadPool pool(m_options.nThreads);
+        for (std::size_t i : order) {
+            // Each task writes only its own entry, so no locking is needed
+            ModelFit* target = &m_fits[i];
+            const std::vector<double>* data = &datasets[i / nFamilies]->values;
+            pool.submit([this, target, data]() {
+                auto taskStart = std::chrono::steady_clock::now();
+                std::unique_ptr<FiniteFunction> function =
+                    makeFamily(target->family, *data, m_options.rangeMin, m_options.rangeMax);
+
+                UnbinnedFit unbinned(*function, *data, 1);
+                target->fit = unbinned.fit(m_options.algorithm);
+
+                const double k = static_cast<double>(target->fit.values.size());
+                const double events = static_cast<double>(target->fit.events);
+                target->aic = 2.0 * target->fit.nll + 2.0 * k;
+                target->bic = 2.0 * target->fit.nll + k * std::log(events);
+
+                BinnedFit binned(*function, *data, m_options.nBins);
+                target->chiSquared = 2.0 * binned.objective(target->fit.values);
+                target->ndof = binned.ndof(target->fit.values.size());
+                target->pValue = chiSquaredPValue(target->chiSquared, target->ndof);
+
+                std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - taskStart;
+                target->seconds = elapsed.count();
+            });
+        }
+    } // pool destructor waits for every fit to finish
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    m_wallSeconds = elapsed.count();
+    m_eventsFitted = 0;
+    for (const ModelFit& fit : m_fits) m_eventsFitted += fit.fit.events;
+    rank();
+}
+
+void ModelSelection::rank() {
+    for (std::size_t first = 0; first < m_fits.size();) {
+        std::size_t last = first;
+        while (last < m_fits.size() && m_fits[last].dataset == m_fits[first].dataset) last++;
+
+        for (std::size_t i = first; i < last; i++) {
+            m_fits[i].rankAIC = 1;
+            m_fits[i].rankBIC = 1;
+            for (std::size_t j = first; j < last; j++) {
+                if (m_fits[j].aic < m_fits[i].aic) m_fits[i].rankAIC++;
+                if (m_fits[j].bic < m_fits[i].bic) m_fits[i].rankBIC++;
+            }
+        }
+        first = last;
+    }
+}
+
+const ModelFit* ModelSelection::best(const std::string& dataset) const {
+    for (const ModelFit& fit : m_fits) {
+        if (fit.dataset == dataset && fit.rankAIC == 1) return &fit;
+    }
+    return nullptr;
+}
+
+void ModelSelection::printSummary(std::ostream& out) const {
+    out << std::left << std::setw(20) << "Dataset"
+        << std::setw(16) << "Best (AIC)"
+        << std::setw(16) << "Best (BIC)"
+        << std::right << std::setw(12) << "dAIC"
+        << std::setw(14) << "chi2/NDOF"
+        << std::setw(12) << "p-value" << std::endl;
+    out << std::string(90, '-') << std::endl;
+
+    std::vector<int> wins(3, 0);
+    for (std::size_t first = 0; first < m_fits.size();) {
+        std::size_t last = first;
+        while (last < m_fits.size() && m_fits[last].dataset == m_fits[first].dataset) last++;
+
+        const ModelFit* bestAIC = nullptr;
+        const ModelFit* bestBIC = nullptr;
+        double runnerUp = std::numeric_limits<double>::infinity();
+        for (std::size_t i = first; i < last; i++) {
+            if (m_fits[i].rankAIC == 1) bestAIC = &m_fits[i];
+            if (m_fits[i].rankBIC == 1) bestBIC = &m_fits[i];
+            if (m_fits[i].rankAIC == 2) runnerUp = std::min(runnerUp, m_fits[i].aic);
+        }
+        wins[static_cast<int>(bestAIC->family)]++;
+
+        out << std::left << std::setw(20) << bestAIC->dataset
+            << std::setw(16) << familyName(bestAIC->family)
+            << std::setw(16) << familyName(bestBIC->family)
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(12) << runnerUp - bestAIC->aic
+            << std::setprecision(3)
+            << std::setw(14) << bestAIC->chiSquared / bestAIC->ndof
+            << std::setw(12) << bestAIC->pValue
+            << (bestAIC->fit.converged ? "" : "  (not converged)") << std::endl;
+        first = last;
+    }
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+    out << std::string(90, '-') << std::endl;
+    out << "Best by AIC: Normal " << wins[0] << ", Cauchy-Lorentz " << wins[1] << ", Crystal Ball " << wins[2]
+        << std::endl;
+}
+
+void ModelSelection::printTiming(std::ostream& out, int slowest) const {
+    double taskSeconds = 0.0;
+    for (const ModelFit& fit : m_fits) taskSeconds += fit.seconds;
+
+    out << m_fits.size() << " fits in " << m_wallSeconds << " s: " << m_fits.size() / m_wallSeconds << " fits/s, "
+        << m_eventsFitted / m_wallSeconds / 1e6 << " million events fitted per second" << std::endl;
+    out << "Sum of per-fit times " << taskSeconds << " s, " << taskSeconds / m_wallSeconds
+        << "x the wall time" << std::endl;
+
+    std::vector<const ModelFit*> sorted;
+    for (const ModelFit& fit : m_fits) sorted.push_back(&fit);
+    std::sort(sorted.begin(), sorted.end(), [](const ModelFit* a, const ModelFit* b) { return a->seconds > b->seconds; });
+    out << "Slowest fits:" << std::endl;
+    for (int i = 0; i < slowest && i < static_cast<int>(sorted.size()); i++) {
+        const ModelFit& fit = *sorted[i];
+        out << "  " << std::left << std::setw(20) << fit.dataset << std::setw(16) << familyName(fit.family)
+            << std::right << std::setw(10) << fit.seconds << " s, " << fit.fit.iterations << " iterations, "
+            << fit.fit.calls << " + " << fit.fit.gradientCalls << " gradient evaluations"
+            << (fit.fit.converged ? "" : " (not converged)") << std::endl;
+    }
+}
+
+bool ModelSelection::writeTable(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file) {
+        std::cerr << "Error: Could not open " << path << " for writing" << std::endl;
+        return false;
+    }
+
+    file << "# dataset family events nll aic rank_aic bic rank_bic chi2 ndof p_value converged seconds parameters"
+         << std::endl;
+    file << std::setprecision(10);
+    for (const ModelFit& fit : m_fits) {
+        file << fit.dataset << " " << familyName(fit.family) << " " << fit.fit.events << " " << fit.fit.nll << " "
+             << fit.aic << " " << fit.rankAIC << " " << fit.bic << " " << fit.rankBIC << " " << fit.chiSquared << " "
+             << fit.ndof << " " << fit.pValue << " " << (fit.fit.converged ? 1 : 0) << " " << fit.seconds << " "
+             << parameterList(fit.fit) << std::endl;
+    }
+    return true;
+}
@@ -0,0 +1,106 @@
+// ModelSelection.h
+// Fit every distribution family to every dataset and rank the families
+// William Hopkins
+// October 2026
+//
+// Each (dataset, family) pair is one task: an unbinned maximum-likelihood fit
+// started from the sample mean and RMS, followed by a binned Poisson
+// goodness-of-fit test at the best fit. The tasks run on a thread pool, the
+// slowest kinds (Crystal Ball, large datasets) first so no long fit is left
+// running alone at the end. Each fit uses one thread; the parallelism comes
+// from running many fits at once.
+//
+// The families are ranked per dataset by
+//   AIC = 2 NLL + 2 k        BIC = 2 NLL + k log N
+// for k parameters and N events. Lower is better; only differences within a
+// dataset mean anything.
+//
+//   DataCatalog catalog("../../../Data");
+//   catalog.loadAll();
+//   ModelSelection selection;
+//   selection.run(catalog);
+//   selection.writeTable("model_selection.txt");
+
+#ifndef MODELSELECTION_H
+#define MODELSELECTION_H
+
+#include "DataCatalog.h"
+#include "LikelihoodFit.h"
+#include "../FiniteFunctions.h"
+#include <vector>
+#include <string>
+#include <memory>
+#include <ostream>
+
+enum class Family { Normal, CauchyLorentz, CrystalBall };
+
+const char* familyName(Family family);
+
+// A distribution of the given family over [low, high], with starting values
+// taken from data (mean and RMS; the Crystal Ball tail starts at alpha = 1.5,
+// n = 3)
+std::unique_ptr<FiniteFunction> makeFamily(Family family, const std::vector<double>& data, double low, double high);
+
+struct SelectionOptions {
+    std::vector<Family> families = {Family::Normal, Family::CauchyLorentz, Family::CrystalBall};
+    double rangeMin = -10.0;
+    double rangeMax = 10.0;
+    int nBins = 100;            // bins for the goodness-of-fit test
+    int nThreads = 0;           // <= 0 uses one per core
+    MinimiserAlgorithm algorithm = MinimiserAlgorithm::Migrad;
+};
+
+// One family fitted to one dataset
+struct ModelFit {
+    std::string dataset;
+    Family family = Family::Normal;
+    FitResult fit;              // unbinned fit
+    double aic = 0.0;
+    double bic = 0.0;
+    double chiSquared = 0.0;    // binned Poisson likelihood ratio at the best fit
+    long long ndof = 0;         // BinnedFit::ndof for this family
+    double pValue = 0.0;        // of chiSquared, Wilson-Hilferty approximation
+    int rankAIC = 0;            // 1 = best of the families for this dataset
+    int rankBIC = 0;
+    double seconds = 0.0;       // wall time of the task (fit and test)
+};
+
+// Upper-tail probability of chi-squared with ndof degrees of freedom, from
+// the Wilson-Hilferty normal approximation (good to a few per cent for
+// ndof >~ 10, which covers binned tests)
+double chiSquaredPValue(double chiSquared, long long ndof);
+
+class ModelSelection {
+public:
+    explicit ModelSelection(SelectionOptions options = {});
+
+    // Fit every family to every loaded dataset in catalog
+    void run(const DataCatalog& catalog);
+
+    // All fits, grouped by dataset (in catalog order) then family
+    const std::vector<ModelFit>& fits() const { return m_fits; }
+
+    // The best fit to dataset by AIC, or nullptr if there is none
+    const ModelFit* best(const std::string& dataset) const;
+
+    // One row per dataset: the winners by AIC and BIC, the AIC margin to
+    // the runner-up, and the goodness of fit of the winner
+    void printSummary(std::ostream& out) const;
+
+    // Throughput of the last run and its n slowest fits
+    void printTiming(std::ostream& out, int slowest = 5) const;
+
+    // Every fit, one row each, as a whitespace-separated table. Returns false
+    // if the file could not be written.
+    bool writeTable(const std::string& path) const;
+
+private:
+    SelectionOptions m_options;
+    std::vector<ModelFit> m_fits;
+    double m_wallSeconds = 0.0;
+    long long m_eventsFitted = 0; // summed over every task
+
+    void rank(); // fill in rankAIC and rankBIC within each dataset
+};
+
+#endif
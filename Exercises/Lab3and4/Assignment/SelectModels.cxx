@@ -0,0 +1,40 @@
+// SelectModels.cxx
+// Fit every distribution to every MysteryData file and rank them by AIC/BIC
+// William Hopkins
+// October 2026
+
+#include "DataCatalog.h"
+#include "ModelSelection.h"
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "  Model Selection over all MysteryData" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    // Optional arguments: data directory, number of threads and output table
+    std::string directory = (argc > 1) ? argv[1] : "../../../Data";
+    int nThreads = (argc > 2) ? std::stoi(argv[2]) : 0;
+    std::string output = (argc > 3) ? argv[3] : "model_selection.txt";
+
+    DataCatalog catalog(directory);
+    if (catalog.size() == 0) {
+        std::cerr << "No data files found in " << directory << std::endl;
+        return 1;
+    }
+    catalog.loadAll(nThreads);
+
+    SelectionOptions options;
+    options.nThreads = nThreads;
+    ModelSelection selection(options);
+    selection.run(catalog);
+
+    std::cout << std::endl;
+    selection.printSummary(std::cout);
+    std::cout << std::endl;
+    selection.printTiming(std::cout);
+
+    if (selection.writeTable(output)) std::cout << "\nEvery fit written to " << output << std::endl;
+    return 0;
+}
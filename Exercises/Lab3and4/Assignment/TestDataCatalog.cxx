@@ -0,0 +1,31 @@
+// TestDataCatalog.cxx
+// Load every MysteryData file at once and list what was found
+// William Hopkins
+// October 2026
+
+#include "DataCatalog.h"
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    std::cout << "========================================" << std::endl;
+    std::cout << "  MysteryData Catalog" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    // Optional arguments: data directory and number of loader threads
+    std::string directory = (argc > 1) ? argv[1] : "../../../Data";
+    int nThreads = (argc > 2) ? std::stoi(argv[2]) : 0;
+
+    DataCatalog catalog(directory);
+    if (catalog.size() == 0) {
+        std::cerr << "No data files found in " << directory << std::endl;
+        return 1;
+    }
+
+    std::cout << "Found " << catalog.size() << " data files" << std::endl;
+    catalog.loadAll(nThreads);
+    std::cout << std::endl;
+    catalog.printSummary();
+
+    return 0;
+}
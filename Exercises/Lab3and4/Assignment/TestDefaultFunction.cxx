@@ -4,32 +4,12 @@
 // December 2025
 
 #include "../FiniteFunctions.h"
+#include "DataLoader.h"
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
 #include <filesystem>
 
-// Read data from file
-std::vector<double> readMysteryData(const std::string& filename) {
-    std::vector<double> data;
-    std::ifstream file(filename);
-
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return data;
-    }
-
-    double value;
-    while (file >> value) {
-        data.push_back(value);
-    }
-
-    file.close();
-    std::cout << "Read " << data.size() << " data points from " << filename << std::endl;
-    return data;
-}
-
 int main() {
     std::cout << "========================================" << std::endl;
     std::cout << "  Testing Default FiniteFunction" << std::endl;
@@ -4,33 +4,13 @@
 // December 2025
 
 #include "../FiniteFunctions.h"
+#include "DataLoader.h"
 #include "Distributions.h"
 #include <iostream>
-#include <fstream>
 #include <vector>
 #include <string>
 #include <filesystem>
 
-// Read data from file
-std::vector<double> readMysteryData(const std::string& filename) {
-    std::vector<double> data;
-    std::ifstream file(filename);
-
-    if (!file.is_open()) {
-        std::cerr << "Error: Could not open file " << filename << std::endl;
-        return data;
-    }
-
-    double value;
-    while (file >> value) {
-        data.push_back(value);
-    }
-
-    file.close();
-    std::cout << "Read " << data.size() << " data points from " << filename << std::endl;
-    return data;
-}
-
 int main() {
     std::cout << "========================================" << std::endl;
     std::cout << "  Distribution Testing Program" << std::endl;
@@ -3,11 +3,28 @@
 #include <vector>
 #include "FiniteFunctions.h"
 #include <filesystem> //To check extensions in a nice way
+#include <cmath>
+#include <numeric>
+#include <algorithm>
+#include <queue>
 
 #include "gnuplot-iostream.h" //Needed to produce plots (not part of the course) 
 
 using std::filesystem::path;
 
+//Gauss-Kronrod rule on [-1,1]: the 15 Kronrod nodes are 0 and +-xgk[j], and the 7 Gauss nodes are 0 and
+//+-xgk[1], +-xgk[3], +-xgk[5], so one set of 15 calls gives both estimates
+static const double xgk[8] = {0.991455371120812639206854697526329, 0.949107912342758524526189684047851,
+                              0.864864423359769072789712788640926, 0.741531185599394439863864773280788,
+                              0.586087235467691130294144845693013, 0.405845151377397166906606412076961,
+                              0.207784955007898467600689403773245, 0.0};
+static const double wgk[8] = {0.022935322010529224963732008058970, 0.063092092629978553290700663189204,
+                              0.104790010322250183839876322541518, 0.140653259715525918745189590510238,
+                              0.169004726639267902826583426598550, 0.190350578064785409913256402421014,
+                              0.204432940075298892414161999234649, 0.209482141084727828012999174891714};
+static const double wg[4] = {0.129484966168869693270611432679082, 0.279705391489276667901467771423780,
+                             0.381830050505118944950369775488975, 0.417959183673469387755102040816327};
+
 //Empty constructor
 FiniteFunction::FiniteFunction(){
   m_RMin = -5.0;
@@ -27,6 +44,7 @@ FiniteFunction::FiniteFunction(double range_min, double range_max, std::string o
 //Plots are called in the destructor
 //SUPACPP note: They syntax of the plotting code is not part of the course
 FiniteFunction::~FiniteFunction(){
+  if (!m_plotfunction && !m_plotdatapoints && !m_plotsamplepoints) return; //Nothing to plot, so don't start gnuplot (e.g. functions made only for fitting)
   Gnuplot gp; //Set up gnuplot object
   this->generatePlot(gp); //Generate the plot and save it to a png using "outfile" for naming 
 }
@@ -56,6 +74,148 @@ double FiniteFunction::rangeMax() {return m_RMax;};
 double FiniteFunction::invxsquared(double x) {return 1/(1+x*x);};
 double FiniteFunction::callFunction(double x) {return this->invxsquared(x);}; //(overridable)
 
+/*
+###################
+//Parameters (overridable, the default function has none)
+###################
+*/
+std::vector<std::string> FiniteFunction::parameterNames() {return {};};
+std::vector<double> FiniteFunction::getParameters() {return {};};
+void FiniteFunction::setParameters(const std::vector<double> &params) {this->invalidateIntegral();};
+std::pair<double,double> FiniteFunction::naturalBounds(int i) {return std::make_pair(-INFINITY, INFINITY);};
+
+int FiniteFunction::nParameters() {return this->getParameters().size();};
+
+double FiniteFunction::getParameter(int i){
+  std::vector<double> params = this->getParameters();
+  if (i < 0 || i >= (int)params.size()){
+    std::cout << "No parameter " << i << " (the function has " << params.size() << ")" << std::endl;
+    return NAN;
+  }
+  return params[i];
+}
+
+void FiniteFunction::setParameter(int i, double value){
+  std::vector<double> params = this->getParameters();
+  if (i < 0 || i >= (int)params.size()){
+    std::cout << "No parameter " << i << " (the function has " << params.size() << ")" << std::endl;
+    return;
+  }
+  //The natural bounds are open (sigma > 0 excludes sigma = 0), those set with setParameterBounds are closed
+  std::pair<double,double> natural = this->naturalBounds(i);
+  if (!(value > natural.first && value < natural.second)){
+    std::cout << "Parameter " << this->parameterNames()[i] << " = " << value << " is outside its natural bounds ("
+              << natural.first << ", " << natural.second << "), not changed" << std::endl;
+    return;
+  }
+  std::pair<double,double> bounds = this->parameterBounds(i);
+  if (!(value >= bounds.first && value <= bounds.second)){
+    std::cout << "Parameter " << this->parameterNames()[i] << " = " << value << " is outside its bounds ["
+              << bounds.first << ", " << bounds.second << "], not changed" << std::endl;
+    return;
+  }
+  params[i] = value;
+  this->setParameters(params);
+}
+
+//Natural bounds narrowed by any set with setParameterBounds
+std::pair<double,double> FiniteFunction::parameterBounds(int i){
+  std::pair<double,double> bounds = this->naturalBounds(i);
+  if (i >= 0 && i < (int)m_bounds.size()){
+    bounds.first = std::max(bounds.first, m_bounds[i].first);
+    bounds.second = std::min(bounds.second, m_bounds[i].second);
+  }
+  return bounds;
+}
+
+void FiniteFunction::setParameterBounds(int i, double low, double high){
+  if (i < 0 || i >= this->nParameters() || !(low < high)){
+    std::cout << "Invalid bounds [" << low << ", " << high << "] for parameter " << i << ", ignored" << std::endl;
+    return;
+  }
+  if ((int)m_bounds.size() < this->nParameters()) m_bounds.resize(this->nParameters(), std::make_pair(-INFINITY, INFINITY));
+  m_bounds[i] = std::make_pair(low, high);
+}
+
+//Plain loop over callFunction; the distributions override this with closed forms of log(f)
+double FiniteFunction::sumLogFunction(const double *x, int n){
+  double sum = 0.0;
+  for (int i = 0; i < n; i++) sum += log(this->callFunction(x[i]));
+  return sum;
+}
+
+//No parameters, so nothing to differentiate
+bool FiniteFunction::hasGradient() {return false;};
+void FiniteFunction::callFunctionGradient(const double *x, int n, double *values, double *gradients){
+  int k = this->nParameters();
+  for (int i = 0; i < n; i++) values[i] = this->callFunction(x[i]);
+  std::fill(gradients, gradients + n * k, 0.0);
+}
+
+//dlog(f)/dp = (df/dp) / f, a block of points at a time
+double FiniteFunction::sumLogGradient(const double *x, int n, double *gradient){
+  const int block = 256;
+  int k = this->nParameters();
+  std::vector<double> values(block), gradients(block * k);
+  double sum = 0.0;
+  for (int start = 0; start < n; start += block){
+    int m = std::min(block, n - start);
+    this->callFunctionGradient(x + start, m, values.data(), gradients.data());
+    for (int i = 0; i < m; i++){
+      double inverse = 1.0 / values[i];
+      sum += log(values[i]);
+      for (int j = 0; j < k; j++) gradient[j] += gradients[i * k + j] * inverse;
+    }
+  }
+  return sum;
+}
+
+//Same rule and points as integral(Ndiv), so the derivatives match it
+double FiniteFunction::integralGradient(int Ndiv, double *gradient){
+  if (Ndiv <= 0) Ndiv = 1000;
+  int k = this->nParameters();
+  if (m_IntMethod == IntegrationMethod::GaussKronrod){
+    this->integral(Ndiv); //Picks the intervals (the derivatives are taken with them held fixed)
+    std::vector<double> x, weights;
+    for (const std::pair<double,double> &interval : m_IntIntervals){
+      double centre = 0.5 * (interval.first + interval.second);
+      double half = 0.5 * (interval.second - interval.first);
+      x.push_back(centre);
+      weights.push_back(wgk[7] * half);
+      for (int j = 0; j < 7; j++){
+        x.push_back(centre - half * xgk[j]);
+        x.push_back(centre + half * xgk[j]);
+        weights.push_back(wgk[j] * half);
+        weights.push_back(wgk[j] * half);
+      }
+    }
+    int n = x.size();
+    std::vector<double> values(n), gradients(n * k);
+    this->callFunctionGradient(x.data(), n, values.data(), gradients.data());
+    double sum = 0.0;
+    std::fill(gradient, gradient + k, 0.0);
+    for (int i = 0; i < n; i++){
+      sum += weights[i] * values[i];
+      for (int j = 0; j < k; j++) gradient[j] += weights[i] * gradients[i * k + j];
+    }
+    return sum;
+  }
+
+  double step = (m_RMax - m_RMin) / (double)Ndiv;
+  std::vector<double> x(Ndiv + 1), values(Ndiv + 1), gradients((Ndiv + 1) * k);
+  for (int i = 0; i <= Ndiv; i++) x[i] = m_RMin + i * step;
+  this->callFunctionGradient(x.data(), Ndiv + 1, values.data(), gradients.data());
+
+  double sum = 0.0;
+  std::fill(gradient, gradient + k, 0.0);
+  for (int i = 0; i <= Ndiv; i++){
+    double weight = (i == 0 || i == Ndiv) ? 0.5 * step : step;
+    sum += weight * values[i];
+    for (int j = 0; j < k; j++) gradient[j] += weight * gradients[i * k + j];
+  }
+  return sum;
+}
+
 /*
 ###################
 Integration by hand (output needed to normalise function when plotting)
@@ -66,18 +226,91 @@ double FiniteFunction::integrate(int Ndiv){ //private
   double step = (m_RMax - m_RMin) / (double)Ndiv;
   double sum = 0.0;
 
-  // Sum up the areas of trapezoids
+  // Sum up the areas of trapezoids, reusing each trapezoid's right edge as the next one's left
+  double y1 = this->callFunction(m_RMin);
   for (int i = 0; i < Ndiv; i++) {
-    double x1 = m_RMin + i * step;
     double x2 = m_RMin + (i + 1) * step;
-    double y1 = this->callFunction(x1);
     double y2 = this->callFunction(x2);
     sum += (y1 + y2) * step / 2.0;  // Area of trapezoid
+    y1 = y2;
   }
+  m_IntCalls = Ndiv + 1;
+  m_IntError = 0.0;
 
   return sum;
 }
+
+//One G7/K15 pair over [a,b]: the Kronrod estimate, with |K15 - G7| (a pessimistic bound on its error) in error
+double FiniteFunction::gaussKronrod(double a, double b, double &error){ //private
+  double centre = 0.5 * (a + b);
+  double half = 0.5 * (b - a);
+  double fc = this->callFunction(centre);
+  double kronrod = wgk[7] * fc;
+  double gauss = wg[3] * fc;
+  for (int j = 0; j < 7; j++){
+    double f = this->callFunction(centre - half * xgk[j]) + this->callFunction(centre + half * xgk[j]);
+    kronrod += wgk[j] * f;
+    if (j % 2 == 1) gauss += wg[j / 2] * f; //Gauss nodes are every other Kronrod node
+  }
+  m_IntCalls += 15;
+  error = fabs((kronrod - gauss) * half);
+  return kronrod * half;
+}
+
+//Start from the whole range and keep bisecting the interval with the largest error estimate, so the
+//evaluations go where the function changes quickly (e.g. a narrow peak) rather than on flat tails
+double FiniteFunction::integrateAdaptive(){ //private
+  struct Interval {double a, b, value, error;};
+  auto smaller = [](const Interval &x, const Interval &y) {return x.error < y.error;};
+  std::priority_queue<Interval, std::vector<Interval>, decltype(smaller)> intervals(smaller);
+
+  m_IntCalls = 0;
+  Interval whole{m_RMin, m_RMax, 0.0, 0.0};
+  whole.value = this->gaussKronrod(whole.a, whole.b, whole.error);
+  intervals.push(whole);
+  double total = whole.value;
+  double error = whole.error;
+
+  //Each bisection costs 30 calls. Stops early if the integral is not finite (error is then NaN). The absolute
+  //tolerance ends the loop when the integral is (close to) zero, where no relative error can be met
+  while (error > std::max(m_IntTolerance * fabs(total), m_IntAbsTolerance) && m_IntCalls + 30 <= m_IntMaxCalls){
+    Interval worst = intervals.top();
+    double middle = 0.5 * (worst.a + worst.b);
+    if (!(middle > worst.a && middle < worst.b)) break; //Too narrow to split any further
+    intervals.pop();
+    Interval left{worst.a, middle, 0.0, 0.0};
+    Interval right{middle, worst.b, 0.0, 0.0};
+    left.value = this->gaussKronrod(left.a, left.b, left.error);
+    right.value = this->gaussKronrod(right.a, right.b, right.error);
+    total += left.value + right.value - worst.value;
+    error += left.error + right.error - worst.error;
+    intervals.push(left);
+    intervals.push(right);
+  }
+
+  //Add up again from left to right, free of the rounding in the running sums
+  std::vector<Interval> sorted;
+  for (; !intervals.empty(); intervals.pop()) sorted.push_back(intervals.top());
+  std::sort(sorted.begin(), sorted.end(), [](const Interval &x, const Interval &y) {return x.a < y.a;});
+  total = 0.0;
+  m_IntError = 0.0;
+  m_IntIntervals.clear();
+  for (const Interval &interval : sorted){
+    total += interval.value;
+    m_IntError += interval.error;
+    m_IntIntervals.push_back(std::make_pair(interval.a, interval.b));
+  }
+  return total;
+}
+
 double FiniteFunction::integral(int Ndiv) { //public
+  if (m_IntMethod == IntegrationMethod::GaussKronrod){
+    if (m_Integral == 0.0 || m_IntDiv != -1){
+      m_IntDiv = -1;
+      m_Integral = this->integrateAdaptive();
+    }
+    return m_Integral; //Kept until the parameters or the method change
+  }
   if (Ndiv <= 0){
     std::cout << "Invalid number of divisions for integral, setting Ndiv to 1000" <<std::endl;
     Ndiv = 1000;
@@ -89,6 +322,31 @@ double FiniteFunction::integral(int Ndiv) { //public
   }
   else return m_Integral; //Don't bother re-calculating integral if Ndiv is the same as the last call
 }
+void FiniteFunction::setIntegrationMethod(IntegrationMethod method, double tolerance, int maxCalls, double absTolerance){
+  if (!(tolerance > 0.0)){
+    std::cout << "Invalid integration tolerance " << tolerance << ", setting it to 1e-9" << std::endl;
+    tolerance = 1e-9;
+  }
+  if (!(absTolerance >= 0.0)){
+    std::cout << "Invalid absolute integration tolerance " << absTolerance << ", setting it to 1e-15" << std::endl;
+    absTolerance = 1e-15;
+  }
+  if (maxCalls < 15){
+    std::cout << "Integration needs at least 15 calls, setting maxCalls to 15" << std::endl;
+    maxCalls = 15;
+  }
+  m_IntMethod = method;
+  m_IntTolerance = tolerance;
+  m_IntAbsTolerance = absTolerance;
+  m_IntMaxCalls = maxCalls;
+  this->invalidateIntegral();
+}
+double FiniteFunction::integralError() {return m_IntError;};
+int FiniteFunction::integralCalls() {return m_IntCalls;};
+void FiniteFunction::invalidateIntegral(){
+  m_Integral = 0.0; //Same as the "not set" value checked in integral() and scanFunction()
+  m_IntDiv = 0;
+}
 
 /*
 ###################
@@ -107,7 +365,11 @@ void FiniteFunction::checkPath(std::string outfile){
 void FiniteFunction::printInfo(){
   std::cout << "rangeMin: " << m_RMin << std::endl;
   std::cout << "rangeMax: " << m_RMax << std::endl;
-  std::cout << "integral: " << m_Integral << ", calculated using " << m_IntDiv << " divisions" << std::endl;
+  if (m_IntDiv == -1){
+    std::cout << "integral: " << m_Integral << ", calculated adaptively (G7/K15) with " << m_IntCalls
+              << " calls, error estimate " << m_IntError << std::endl;
+  }
+  else std::cout << "integral: " << m_Integral << ", calculated using " << m_IntDiv << " divisions" << std::endl;
   std::cout << "function: " << m_FunctionName << std::endl;
 }
 
@@ -135,6 +397,16 @@ void FiniteFunction::plotData(std::vector<double> &points, int Nbins, bool isdat
     m_plotsamplepoints = true;
   }
 }
+void FiniteFunction::plotData(ValueStream &points, int Nbins, bool isdata){
+  if (isdata){
+    m_data = this->makeHist(points,Nbins);
+    m_plotdatapoints = true;
+  }
+  else{
+    m_samples = this->makeHist(points,Nbins);
+    m_plotsamplepoints = true;
+  }
+}
 
 
 /*
@@ -155,7 +427,14 @@ std::vector< std::pair<double,double> > FiniteFunction::scanFunction(int Nscan){
   if (m_Integral == NULL) {
     std::cout << "Integral not set, doing it now" << std::endl;
     this->integral(Nscan);
-    std::cout << "integral: " << m_Integral << ", calculated using " << Nscan << " divisions" << std::endl;
+    if (m_IntMethod == IntegrationMethod::GaussKronrod){
+      std::cout << "integral: " << m_Integral << " +- " << this->integralError() << ", calculated by adaptive Gauss-Kronrod using "
+                << this->integralCalls() << " calls" << std::endl;
+    }
+    else {
+      std::cout << "integral: " << m_Integral << ", calculated by the trapezoid rule using " << Nscan << " divisions ("
+                << this->integralCalls() << " calls)" << std::endl;
+    }
   }
   //For each scan point push back the x and y values 
   for (int i = 0; i < Nscan; i++){
@@ -167,16 +446,50 @@ std::vector< std::pair<double,double> > FiniteFunction::scanFunction(int Nscan){
 
 //Function to make histogram out of sampled x-values - use for input data and sampling
 std::vector< std::pair<double,double> > FiniteFunction::makeHist(std::vector<double> &points, int Nbins){
+  std::vector<long long> bins = this->binData(points, Nbins);
+  return this->normaliseHist(bins, std::accumulate(bins.begin(), bins.end(), 0LL));
+}
 
-  std::vector< std::pair<double,double> > histdata; //Plottable output shape: (midpoint,frequency)
-  std::vector<int> bins(Nbins,0); //vector of Nbins ints with default value 0 
-  int norm = 0;
+//Streaming version: only one block of the file is held in memory at a time
+std::vector< std::pair<double,double> > FiniteFunction::makeHist(ValueStream &points, int Nbins){
+  std::vector<long long> bins = this->binData(points, Nbins);
+  return this->normaliseHist(bins, std::accumulate(bins.begin(), bins.end(), 0LL));
+}
+
+//Counts per bin, before normalisation (also used by the binned fits)
+std::vector<long long> FiniteFunction::binData(const std::vector<double> &points, int Nbins){
+  std::vector<long long> bins(Nbins,0); //vector of Nbins counts with default value 0 
+  long long norm = 0;
+  this->fillBins(points, bins, norm);
+  return bins;
+}
+
+std::vector<long long> FiniteFunction::binData(ValueStream &points, int Nbins){
+  std::vector<long long> bins(Nbins,0);
+  long long norm = 0;
+  ValueStream::Block block;
+  points.rewind();
+  while (points.next(block)){
+    this->fillBins(block, bins, norm);
+  }
+  return bins;
+}
+
+void FiniteFunction::fillBins(const std::vector<double> &points, std::vector<long long> &bins, long long &norm){
+  int Nbins = bins.size();
   for (double point : points){
+    if (!(point >= m_RMin && point <= m_RMax)) continue; //Points outside the function range can't be drawn (same range as the unbinned fits)
     //Get bin index (starting from 0) the point falls into using point value, range, and Nbins
     int bindex = static_cast<int>(floor((point-m_RMin)/((m_RMax-m_RMin)/(double)Nbins)));
+    bindex = std::min(bindex, Nbins-1); //x == RMax belongs to the last bin
     bins[bindex]++; //weight of 1 for each data point
     norm++; //Total number of data points
   }
+}
+
+std::vector< std::pair<double,double> > FiniteFunction::normaliseHist(const std::vector<long long> &bins, long long norm){
+  std::vector< std::pair<double,double> > histdata; //Plottable output shape: (midpoint,frequency)
+  int Nbins = bins.size();
   double binwidth = (m_RMax-m_RMin)/(double)Nbins;
   for (int i=0; i<Nbins; i++){
     double midpoint = m_RMin + i*binwidth + binwidth/2; //Just put markers at the midpoint rather than drawing bars
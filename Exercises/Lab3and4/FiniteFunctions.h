@@ -1,18 +1,28 @@
 #include <string>
 #include <vector>
 #include "gnuplot-iostream.h"
+#include "DataStream.h"
 
 #pragma once //Replacement for IFNDEF
 
+//How integral() integrates the function over its range
+enum class IntegrationMethod {
+  Trapezoid,   //Fixed step, Ndiv divisions (the default)
+  GaussKronrod //Adaptive 7-point Gauss / 15-point Kronrod, bisecting the worst interval until the error estimate meets a tolerance
+};
+
 class FiniteFunction{
 
 public:
   FiniteFunction(); //Empty constructor
   FiniteFunction(double range_min, double range_max, std::string outfile); //Variable constructor
-  ~FiniteFunction(); //Destructor
+  virtual ~FiniteFunction(); //Destructor (draws the plot, if anything was plotted). Virtual, so the distributions can be owned through FiniteFunction pointers
   double rangeMin(); //Low end of the range the function is defined within
   double rangeMax(); //High end of the range the function is defined within
-  double integral(int Ndiv = 1000); 
+  double integral(int Ndiv = 1000); //Integral over the range, with the method set by setIntegrationMethod (Ndiv is ignored by the adaptive method)
+  void setIntegrationMethod(IntegrationMethod method, double tolerance = 1e-9, int maxCalls = 2000, double absTolerance = 1e-15); //For GaussKronrod: relative tolerance, the most callFunction calls one integral may use, and an absolute error that is always good enough (for integrals near zero)
+  double integralError(); //Error estimate of the last integral (|K15 - G7| summed over intervals; 0 for the trapezoid rule)
+  int integralCalls(); //Number of callFunction calls made by the last integral
   std::vector< std::pair<double,double> > scanFunction(int Nscan = 1000); //Scan over function to plot it (slight hack needed to plot function in gnuplot)
   void setRangeMin(double RMin);
   void setRangeMax(double RMax);
@@ -21,15 +31,42 @@ public:
   
   //Plot the supplied data points (either provided data or points sampled from function) as a histogram using NBins
   void plotData(std::vector<double> &points, int NBins, bool isdata=true); //NB! use isdata flag to pick between data and sampled distributions
+  void plotData(ValueStream &points, int NBins, bool isdata=true); //Same, but histograms a file block by block in constant memory
+  std::vector<long long> binData(const std::vector<double> &points, int Nbins); //Raw counts in Nbins bins over the range, upper edge in the last bin (the binning used by plotData)
+  std::vector<long long> binData(ValueStream &points, int Nbins); //Streaming version of binData (64-bit counts, as a stream may hold over 2^31 points)
   virtual void printInfo(); //Dump parameter info about the current function (Overridable)
   virtual double callFunction(double x); //Call the function with value x (Overridable)
 
+  //Free parameters, for fitting. The default function has none (Overridable)
+  virtual std::vector<std::string> parameterNames();
+  virtual std::vector<double> getParameters();
+  virtual void setParameters(const std::vector<double> &params); //Must call invalidateIntegral() when overridden
+  int nParameters();
+  double getParameter(int i); //Parameter i by index (NaN if there is no parameter i)
+  void setParameter(int i, double value); //Set parameter i, unless value is outside its bounds (the natural ones exclusive)
+  std::pair<double,double> parameterBounds(int i); //(low, high) allowed for parameter i, +-infinity if unbounded
+  void setParameterBounds(int i, double low, double high); //Restrict parameter i further, e.g. to guide a fit
+  virtual double sumLogFunction(const double *x, int n); //Sum of log(callFunction(x[i])) over n points (Overridable, e.g. with a loop that vectorises)
+
+  //Exact derivatives with respect to the parameters, for gradient-based fits. The default function has none (Overridable)
+  virtual bool hasGradient(); //True if callFunctionGradient gives the parameter derivatives
+  virtual void callFunctionGradient(const double *x, int n, double *values, double *gradients); //values[i] = f(x[i]), gradients[i*nParameters()+j] = df/dparam_j at x[i]
+  virtual double sumLogGradient(const double *x, int n, double *gradient); //Returns the sum of log f over n points and adds the sums of dlog(f)/dparam_j to gradient[j] (Overridable, like sumLogFunction)
+  double integralGradient(int Ndiv, double *gradient); //Returns the integral as integral(Ndiv) would (same method and points), with its parameter derivatives in gradient
+
   //Protected members can be accessed by child classes but not users
 protected:
   double m_RMin;
   double m_RMax;
   double m_Integral;
-  int m_IntDiv = 0; //Number of division for performing integral
+  int m_IntDiv = 0; //Number of division for performing integral (-1 when done adaptively)
+  IntegrationMethod m_IntMethod = IntegrationMethod::Trapezoid;
+  double m_IntTolerance = 1e-9; //Relative tolerance of the adaptive integral
+  double m_IntAbsTolerance = 1e-15; //Absolute tolerance of the adaptive integral
+  int m_IntMaxCalls = 2000; //callFunction budget of the adaptive integral
+  double m_IntError = 0.0; //Error estimate of the last integral
+  int m_IntCalls = 0; //callFunction calls made by the last integral
+  std::vector< std::pair<double,double> > m_IntIntervals; //Intervals of the last adaptive integral (reused by integralGradient)
   std::string m_FunctionName;
   std::string m_OutData; //Output filename for data
   std::string m_OutPng; //Output filename for plot
@@ -40,7 +77,15 @@ protected:
   bool m_plotdatapoints = false; //Flag to determine whether to plot input data
   bool m_plotsamplepoints = false; //Flag to determine whether to plot sampled data 
   double integrate(int Ndiv);
+  double integrateAdaptive(); //Adaptive Gauss-Kronrod integral over the range
+  double gaussKronrod(double a, double b, double &error); //K15 estimate over [a,b], with |K15 - G7| in error
+  void invalidateIntegral(); //Force integral() to recalculate, e.g. after the parameters change
+  virtual std::pair<double,double> naturalBounds(int i); //Open range of parameter i where the function is valid, e.g. (0, inf) for sigma > 0 (Overridable)
+  std::vector< std::pair<double,double> > m_bounds; //Bounds set with setParameterBounds (empty until then)
   std::vector< std::pair<double, double> > makeHist(std::vector<double> &points, int Nbins); //Helper function to turn data points into histogram with Nbins
+  std::vector< std::pair<double, double> > makeHist(ValueStream &points, int Nbins); //Streaming version of makeHist
+  void fillBins(const std::vector<double> &points, std::vector<long long> &bins, long long &norm); //Add points to bin counts (shared by both makeHist versions)
+  std::vector< std::pair<double, double> > normaliseHist(const std::vector<long long> &bins, long long norm); //Turn bin counts into (midpoint,density)
   void checkPath(std::string outstring); //Helper function to ensure data and png paths are correct
   void generatePlot(Gnuplot &gp); 
   
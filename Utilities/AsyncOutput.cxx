@@ -0,0 +1,86 @@
+// AsyncOutput.cxx
+// Implementation of the background output stage
+// Date: October 2026
+
+#include "AsyncOutput.h"
+#include <sstream>
+#include <chrono>
+
+AsyncOutput::AsyncOutput(std::size_t maxPending)
+    : m_maxPending(maxPending > 0 ? maxPending : 1) {
+    m_thread = std::thread(&AsyncOutput::run, this);
+}
+
+AsyncOutput::~AsyncOutput() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_notEmpty.notify_all();
+    m_thread.join(); // run() only returns once the queue is empty
+}
+
+void AsyncOutput::submit(const std::string& name, Job job) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_notFull.wait(lock, [this]() { return m_queue.size() < m_maxPending; });
+    m_queue.push_back({name, std::move(job)});
+    lock.unlock();
+    m_notEmpty.notify_one();
+}
+
+std::vector<std::string> AsyncOutput::takeCompleted() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::vector<std::string> completed;
+    completed.swap(m_completed);
+    return completed;
+}
+
+std::size_t AsyncOutput::pending() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_queue.size() + (m_busy ? 1 : 0);
+}
+
+void AsyncOutput::drain() {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this]() { return m_queue.empty() && !m_busy; });
+}
+
+void AsyncOutput::run() {
+    while (true) {
+        Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_notEmpty.wait(lock, [this]() { return m_stopping || !m_queue.empty(); });
+            if (m_queue.empty()) return; // stopping and fully drained
+            entry = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_busy = true;
+        }
+        m_notFull.notify_one();
+
+        auto start = std::chrono::steady_clock::now();
+        std::ostringstream log;
+        bool ok = false;
+        try {
+            ok = entry.job(log);
+        } catch (const std::exception& e) {
+            log << "exception: " << e.what();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        // Report the job's own messages plus how long it took in the background
+        std::string text = log.str();
+        while (!text.empty() && text.back() == '\n') text.pop_back();
+        std::ostringstream message;
+        message << "[background] " << entry.name << (ok ? " finished" : " FAILED")
+                << " after " << elapsed.count() * 1000.0 << " ms";
+        if (!text.empty()) message << ": " << text;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_completed.push_back(message.str());
+            m_busy = false;
+        }
+        m_idle.notify_all();
+    }
+}
@@ -0,0 +1,67 @@
+// AsyncOutput.h
+// Background output stage: writes result files on a separate I/O thread
+// Date: October 2026
+
+#ifndef ASYNCOUTPUT_H
+#define ASYNCOUTPUT_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <ostream>
+#include <cstddef>
+
+// Runs output jobs one at a time on a background I/O thread so the caller
+// can carry on straight away. Jobs should own their data (move the result
+// buffers into the lambda). At most maxPending jobs may be waiting; submit()
+// blocks beyond that (backpressure). Anything a job writes to the stream it
+// is given is collected and handed back through takeCompleted(), so progress
+// messages reach the terminal from the main thread. The destructor waits for
+// every queued job.
+class AsyncOutput {
+public:
+    using Job = std::function<bool(std::ostream& log)>;
+
+    explicit AsyncOutput(std::size_t maxPending = 4);
+    ~AsyncOutput();
+
+    AsyncOutput(const AsyncOutput&) = delete;
+    AsyncOutput& operator=(const AsyncOutput&) = delete;
+
+    // Queue a job; waits while the queue is full
+    void submit(const std::string& name, Job job);
+
+    // Messages from jobs that finished since the last call
+    std::vector<std::string> takeCompleted();
+
+    // Number of jobs queued or running
+    std::size_t pending();
+
+    // Wait until every submitted job has finished
+    void drain();
+
+private:
+    struct Entry {
+        std::string name;
+        Job job;
+    };
+
+    std::size_t m_maxPending;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::condition_variable m_idle;
+    std::deque<Entry> m_queue;
+    std::vector<std::string> m_completed;
+    bool m_busy = false;
+    bool m_stopping = false;
+
+    void run();
+};
+
+#endif
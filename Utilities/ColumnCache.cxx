@@ -0,0 +1,182 @@
+// ColumnCache.cxx
+// Implementation of the binary sidecar cache
+// Date: October 2026
+
+#include "ColumnCache.h"
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <cstddef>
+#include <atomic>
+#include <unistd.h>
+
+namespace {
+
+const char MAGIC[8] = {'S', 'U', 'P', 'A', 'C', 'O', 'L', 'S'};
+const std::uint32_t VERSION = 1;
+const std::size_t ALIGNMENT = 64;
+
+// Fixed 64-byte header at the start of every sidecar
+struct CacheHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t nColumns;
+    std::uint64_t nRows;
+    std::uint64_t sourceSize;
+    std::int64_t sourceMtime;
+    std::uint64_t sourceHash;
+    std::uint8_t padding[16];
+};
+static_assert(sizeof(CacheHeader) == ALIGNMENT, "cache header must fill one alignment block");
+
+std::size_t paddedColumnBytes(std::size_t nRows) {
+    std::size_t bytes = nRows * sizeof(double);
+    return (bytes + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+}
+
+// Source size and mtime, or false if the source cannot be inspected
+bool sourceStamp(const std::string& sourceFile, std::uint64_t& size, std::int64_t& mtime) {
+    std::error_code ec;
+    auto fileSize = std::filesystem::file_size(sourceFile, ec);
+    if (ec) return false;
+    auto writeTime = std::filesystem::last_write_time(sourceFile, ec);
+    if (ec) return false;
+    size = fileSize;
+    mtime = writeTime.time_since_epoch().count();
+    return true;
+}
+
+} // namespace
+
+std::uint64_t hashBytes(const char* data, std::size_t size) {
+    // FNV-1a style mixing, but consuming 8 bytes per step
+    const std::uint64_t prime = 0x100000001b3ULL;
+    std::uint64_t hash = 0xcbf29ce484222325ULL ^ size;
+
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        hash = (hash ^ word) * prime;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; i++) {
+        hash = (hash ^ static_cast<unsigned char>(data[i])) * prime;
+    }
+    return hash;
+}
+
+SourceStamp ColumnCache::stamp(const std::string& sourceFile) {
+    SourceStamp stamp;
+    stamp.valid = sourceStamp(sourceFile, stamp.size, stamp.mtime);
+    return stamp;
+}
+
+std::string ColumnCache::sidecarPath(const std::string& sourceFile) {
+    return sourceFile + ".colcache";
+}
+
+ColumnCache::ColumnCache(const std::string& sourceFile, unsigned nColumns)
+    : m_file(sidecarPath(sourceFile)), m_columns(nColumns) {
+
+    // The columns are stored little-endian and used in place
+    if (std::endian::native != std::endian::little) return;
+    if (!m_file.isOpen() || m_file.size() < sizeof(CacheHeader)) return;
+
+    CacheHeader header;
+    std::memcpy(&header, m_file.data(), sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0) return;
+    if (header.version != VERSION || header.nColumns != nColumns) return;
+    if (m_file.size() != sizeof(CacheHeader) + nColumns * paddedColumnBytes(header.nRows)) return;
+
+    std::uint64_t size;
+    std::int64_t mtime;
+    if (!sourceStamp(sourceFile, size, mtime) || size != header.sourceSize) return;
+
+    // A touched but otherwise identical source is still a cache hit. Record the
+    // new mtime so the next load can skip the hash again.
+    if (mtime != header.sourceMtime) {
+        MappedFile source(sourceFile);
+        if (!source.isOpen() || hashBytes(source.data(), source.size()) != header.sourceHash) return;
+
+        std::fstream sidecar(sidecarPath(sourceFile), std::ios::binary | std::ios::in | std::ios::out);
+        if (sidecar.is_open()) {
+            sidecar.seekp(offsetof(CacheHeader, sourceMtime));
+            sidecar.write(reinterpret_cast<const char*>(&mtime), sizeof(mtime));
+        }
+    }
+
+    m_rows = header.nRows;
+    m_valid = true;
+}
+
+std::span<const double> ColumnCache::column(unsigned i) const {
+    if (!m_valid || i >= m_columns) return {};
+    const char* start = m_file.data() + sizeof(CacheHeader) + i * paddedColumnBytes(m_rows);
+    return {reinterpret_cast<const double*>(start), m_rows};
+}
+
+bool ColumnCache::write(const std::string& sourceFile, const SourceStamp& stamp,
+                        const std::vector<std::span<const double>>& columns) {
+    if (std::endian::native != std::endian::little || columns.empty() || !stamp.valid) return false;
+
+    std::size_t nRows = columns[0].size();
+    for (const auto& column : columns) {
+        if (column.size() != nRows) return false;
+    }
+
+    CacheHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.nColumns = static_cast<std::uint32_t>(columns.size());
+    header.nRows = nRows;
+    header.sourceSize = stamp.size;
+    header.sourceMtime = stamp.mtime;
+
+    // The source may have grown or been rewritten since it was parsed. The
+    // hash is only trusted if the source still matches the stamp afterwards.
+    MappedFile source(sourceFile);
+    if (!source.isOpen() || source.size() != stamp.size) return false;
+    header.sourceHash = hashBytes(source.data(), source.size());
+
+    // Write to a temporary name and rename, so a concurrent reader never maps
+    // a half-written sidecar. The name is unique to this writer (process id
+    // and a per-process counter), so threads caching the same file never
+    // write through the same temporary.
+    static std::atomic<std::uint64_t> writerCount{0};
+    std::string finalPath = sidecarPath(sourceFile);
+    std::string tempPath = finalPath + ".tmp" + std::to_string(::getpid()) + "." + std::to_string(writerCount++);
+    {
+        std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        const char zeros[ALIGNMENT] = {};
+        std::size_t padding = paddedColumnBytes(nRows) - nRows * sizeof(double);
+        for (const auto& column : columns) {
+            out.write(reinterpret_cast<const char*>(column.data()), column.size_bytes());
+            out.write(zeros, padding);
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tempPath);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    std::uint64_t size;
+    std::int64_t mtime;
+    if (!sourceStamp(sourceFile, size, mtime) || size != stamp.size || mtime != stamp.mtime) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec) {
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+    return true;
+}
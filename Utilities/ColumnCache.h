@@ -0,0 +1,59 @@
+// ColumnCache.h
+// Binary sidecar cache for numeric text files
+// Date: October 2026
+
+#ifndef COLUMNCACHE_H
+#define COLUMNCACHE_H
+
+#include "MappedFile.h"
+#include <string>
+#include <vector>
+#include <span>
+#include <cstdint>
+
+// Once a text file has been parsed, its columns are written next to it as
+// <source>.colcache. The sidecar holds a 64-byte header followed by each
+// column as little-endian doubles, every column starting on a 64-byte
+// boundary. The header records the source size, mtime and a content hash,
+// so a stale sidecar is detected and ignored.
+
+// Size and mtime of a source file, taken before it is read
+struct SourceStamp {
+    bool valid = false;  // false if the source could not be inspected
+    std::uint64_t size = 0;
+    std::int64_t mtime = 0;
+};
+
+class ColumnCache {
+public:
+    // Map the sidecar for sourceFile and check it still matches the source
+    ColumnCache(const std::string& sourceFile, unsigned nColumns);
+
+    bool isValid() const { return m_valid; }
+    std::size_t rows() const { return m_rows; }
+    std::span<const double> column(unsigned i) const;
+
+    // Stamp sourceFile before parsing it, for write()
+    static SourceStamp stamp(const std::string& sourceFile);
+
+    // Write (or replace) the sidecar for sourceFile, holding the columns
+    // parsed after stamp was taken. All columns must be the same length.
+    // Nothing is written if the source has changed since the stamp, so the
+    // sidecar never pairs old columns with a newer source. Returns false if
+    // the sidecar could not be written.
+    static bool write(const std::string& sourceFile, const SourceStamp& stamp,
+                      const std::vector<std::span<const double>>& columns);
+
+    static std::string sidecarPath(const std::string& sourceFile);
+
+private:
+    MappedFile m_file;
+    unsigned m_columns = 0;
+    std::size_t m_rows = 0;
+    bool m_valid = false;
+};
+
+// Fast 64-bit content hash used to recognise an unchanged source file
+std::uint64_t hashBytes(const char* data, std::size_t size);
+
+#endif
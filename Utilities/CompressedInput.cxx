@@ -0,0 +1,124 @@
+// CompressedInput.cxx
+// Implementation of the background decompression pipe
+// Date: October 2026
+
+#include "CompressedInput.h"
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/filter/bzip2.hpp>
+#include <boost/iostreams/device/file.hpp>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+#include <algorithm>
+
+Compression detectCompression(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    unsigned char magic[3] = {0, 0, 0};
+    file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    std::streamsize n = file.gcount();
+
+    if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) return Compression::Gzip;
+    if (n >= 3 && magic[0] == 'B' && magic[1] == 'Z' && magic[2] == 'h') return Compression::Bzip2;
+    return Compression::None;
+}
+
+const char* compressionName(Compression type) {
+    switch (type) {
+        case Compression::Gzip: return "gzip";
+        case Compression::Bzip2: return "bzip2";
+        default: return "plain";
+    }
+}
+
+DecompressionPipe::DecompressionPipe(const std::string& filename, Compression type,
+                                     std::size_t blockBytes, std::size_t maxBlocks)
+    : m_filename(filename), m_type(type), m_blockBytes(blockBytes), m_maxBlocks(maxBlocks) {
+    m_thread = std::thread(&DecompressionPipe::produce, this);
+}
+
+DecompressionPipe::~DecompressionPipe() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_cancel = true;
+    }
+    m_notFull.notify_all();
+    m_thread.join();
+}
+
+// Background thread: decompress the file block by block into the queue
+void DecompressionPipe::produce() {
+    namespace io = boost::iostreams;
+
+    try {
+        io::filtering_istream in;
+        if (m_type == Compression::Gzip) {
+            in.push(io::gzip_decompressor());
+        } else if (m_type == Compression::Bzip2) {
+            in.push(io::bzip2_decompressor());
+        }
+        in.push(io::file_source(m_filename, std::ios::binary));
+
+        while (true) {
+            std::vector<char> block(m_blockBytes);
+            in.read(block.data(), block.size());
+            block.resize(static_cast<std::size_t>(in.gcount()));
+
+            if (!block.empty()) {
+                // Backpressure: wait for the consumer rather than buffering the whole file
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_notFull.wait(lock, [this]() { return m_cancel || m_blocks.size() < m_maxBlocks; });
+                if (m_cancel) break;
+                m_blocks.push_back(std::move(block));
+                lock.unlock();
+                m_notEmpty.notify_one();
+            }
+            if (!in) break;
+        }
+
+        // filtering_istream reports decoder errors through badbit rather than throwing
+        if (in.bad() && !m_cancel) {
+            std::cerr << "Error: Could not decompress " << m_filename << std::endl;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_failed = true;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: Could not decompress " << m_filename << " (" << e.what() << ")" << std::endl;
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_failed = true;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_done = true;
+    }
+    m_notEmpty.notify_all();
+}
+
+std::size_t DecompressionPipe::read(char* dst, std::size_t n) {
+    std::size_t copied = 0;
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (copied < n) {
+        m_notEmpty.wait(lock, [this]() { return m_done || !m_blocks.empty(); });
+        if (m_blocks.empty()) break; // finished
+
+        std::vector<char>& front = m_blocks.front();
+        std::size_t take = std::min(n - copied, front.size() - m_frontPos);
+        std::memcpy(dst + copied, front.data() + m_frontPos, take);
+        copied += take;
+        m_frontPos += take;
+
+        if (m_frontPos == front.size()) {
+            m_blocks.pop_front();
+            m_frontPos = 0;
+            m_notFull.notify_one();
+        }
+    }
+    return copied;
+}
+
+bool DecompressionPipe::failed() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_failed;
+}
@@ -0,0 +1,63 @@
+// CompressedInput.h
+// Transparent gzip/bzip2 decompression of input files
+// Date: October 2026
+
+#ifndef COMPRESSEDINPUT_H
+#define COMPRESSEDINPUT_H
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+enum class Compression { None, Gzip, Bzip2 };
+
+// Identify the compression of a file from its magic bytes (not its extension)
+Compression detectCompression(const std::string& filename);
+
+// Name used in log messages ("plain", "gzip", "bzip2")
+const char* compressionName(Compression type);
+
+// Decompresses a file on a background thread through a boost::iostreams
+// filter chain, handing the output over in blocks through a bounded queue.
+// Decompression therefore overlaps with whatever the caller does with the
+// bytes (normally parsing them).
+class DecompressionPipe {
+public:
+    DecompressionPipe(const std::string& filename, Compression type,
+                      std::size_t blockBytes = 1 << 20, std::size_t maxBlocks = 4);
+    ~DecompressionPipe();
+
+    DecompressionPipe(const DecompressionPipe&) = delete;
+    DecompressionPipe& operator=(const DecompressionPipe&) = delete;
+
+    // Copy up to n decompressed bytes into dst, waiting for the background
+    // thread if necessary. Returns 0 once the whole file has been read.
+    std::size_t read(char* dst, std::size_t n);
+
+    // True if the compressed data was corrupt or could not be read
+    bool failed() const;
+
+private:
+    std::string m_filename;
+    Compression m_type;
+    std::size_t m_blockBytes;
+    std::size_t m_maxBlocks;
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_notEmpty;
+    std::condition_variable m_notFull;
+    std::deque<std::vector<char>> m_blocks;
+    std::size_t m_frontPos = 0;  // bytes of m_blocks.front() already read
+    bool m_done = false;
+    bool m_cancel = false;
+    bool m_failed = false;
+
+    void produce();
+};
+
+#endif
@@ -0,0 +1,167 @@
+// DataStream.cxx
+// Implementation of the streaming block readers
+// Date: October 2026
+
+#include "DataStream.h"
+#include "TextParsing.h"
+#include <cstring>
+
+/*
+###################
+ChunkReader
+###################
+*/
+ChunkReader::ChunkReader(const std::string& filename, std::size_t chunkBytes)
+    : m_filename(filename), m_file(filename, std::ios::binary), m_buffer(chunkBytes) {
+    if (!m_file.is_open()) return;
+
+    m_compression = detectCompression(filename);
+    if (m_compression != Compression::None) {
+        m_pipe = std::make_unique<DecompressionPipe>(filename, m_compression);
+    }
+}
+
+std::size_t ChunkReader::fill(char* dst, std::size_t n) {
+    if (m_pipe) return m_pipe->read(dst, n);
+
+    m_file.read(dst, n);
+    return static_cast<std::size_t>(m_file.gcount());
+}
+
+bool ChunkReader::failed() const {
+    if (m_pipe) return m_pipe->failed();
+    return m_file.bad();
+}
+
+bool ChunkReader::nextChunk(const char*& begin, const char*& end) {
+    // Move the unfinished line left over from the last chunk to the front
+    std::size_t carry = m_filled - m_consumed;
+    if (carry > 0 && m_consumed > 0) {
+        std::memmove(m_buffer.data(), m_buffer.data() + m_consumed, carry);
+    }
+    m_filled = carry;
+    m_consumed = 0;
+
+    while (true) {
+        if (!m_eof && m_filled < m_buffer.size()) {
+            std::size_t wanted = m_buffer.size() - m_filled;
+            std::size_t got = fill(m_buffer.data() + m_filled, wanted);
+            m_filled += got;
+            if (got < wanted) m_eof = true;
+        }
+
+        if (m_filled == 0) return false;
+
+        // At end of file everything left is the final chunk
+        if (m_eof) {
+            m_consumed = m_filled;
+            break;
+        }
+
+        // Otherwise hand out everything up to the last complete line
+        const char* data = m_buffer.data();
+        std::size_t i = m_filled;
+        while (i > 0 && data[i - 1] != '\n') i--;
+        if (i > 0) {
+            m_consumed = i;
+            break;
+        }
+
+        // A single line longer than the buffer: grow it and keep reading
+        m_buffer.resize(m_buffer.size() * 2);
+    }
+
+    begin = m_buffer.data();
+    end = m_buffer.data() + m_consumed;
+    return true;
+}
+
+void ChunkReader::rewind() {
+    m_file.clear();
+    m_file.seekg(0);
+    // A compressed stream can't seek, so start decompressing from scratch
+    if (m_pipe) {
+        m_pipe.reset();
+        m_pipe = std::make_unique<DecompressionPipe>(m_filename, m_compression);
+    }
+    m_filled = 0;
+    m_consumed = 0;
+    m_eof = false;
+}
+
+/*
+###################
+PointStream
+###################
+*/
+PointStream::PointStream(const std::string& filename, std::size_t blockSize)
+    : m_filename(filename), m_reader(filename), m_blockSize(blockSize) {
+}
+
+bool PointStream::next(Block& block) {
+    block.clear();
+
+    while (block.size() < m_blockSize) {
+        if (m_pos == m_end && !m_reader.nextChunk(m_pos, m_end)) break;
+
+        const char* lineEnd = findLineEnd(m_pos, m_end);
+        const char* line = m_pos;
+        m_pos = (lineEnd < m_end) ? lineEnd + 1 : m_end;
+
+        // Skip header line and empty lines
+        if (m_headerPending) {
+            m_headerPending = false;
+            continue;
+        }
+        if (lineEnd == line) continue;
+
+        double x, y;
+        if (parsePointLine(line, lineEnd, x, y)) {
+            block.emplace_back(x, y);
+        }
+    }
+
+    return !block.empty();
+}
+
+void PointStream::rewind() {
+    m_reader.rewind();
+    m_pos = m_end = nullptr;
+    m_headerPending = true;
+}
+
+/*
+###################
+ValueStream
+###################
+*/
+ValueStream::ValueStream(const std::string& filename, std::size_t blockSize)
+    : m_filename(filename), m_reader(filename), m_blockSize(blockSize) {
+}
+
+bool ValueStream::next(Block& block) {
+    block.clear();
+
+    while (block.size() < m_blockSize && !m_stopped) {
+        while (m_pos < m_end && isBlank(*m_pos)) m_pos++;
+        if (m_pos == m_end) {
+            if (!m_reader.nextChunk(m_pos, m_end)) break;
+            continue;
+        }
+
+        double value;
+        if (!parseDouble(m_pos, m_end, value)) {
+            m_stopped = true;
+            break;
+        }
+        block.push_back(value);
+    }
+
+    return !block.empty();
+}
+
+void ValueStream::rewind() {
+    m_reader.rewind();
+    m_pos = m_end = nullptr;
+    m_stopped = false;
+}
@@ -0,0 +1,153 @@
+// DataStream.h
+// Pull-based streaming readers that yield data in fixed-size blocks
+// Date: October 2026
+//
+// Unlike readDataFile/readMysteryData these never hold more than one block of
+// values and one read buffer in memory, so arbitrarily large files can be
+// processed in constant memory. gzip and bzip2 files are recognised by their
+// magic bytes and decompressed on a background thread. Both streams can be used with next() or as an
+// input range of blocks:
+//
+//   PointStream stream("input2D_float.txt");
+//   for (const auto& block : stream) { ... }
+
+#ifndef DATASTREAM_H
+#define DATASTREAM_H
+
+#include <string>
+#include <vector>
+#include <utility>
+#include <fstream>
+#include <memory>
+#include <cstddef>
+#include "CompressedInput.h"
+#include "Points2D.h"
+
+// Reads a text file (plain or compressed) in fixed-size chunks, each ending
+// on a line boundary
+class ChunkReader {
+public:
+    explicit ChunkReader(const std::string& filename, std::size_t chunkBytes = 1 << 20);
+
+    bool isOpen() const { return m_file.is_open(); }
+    Compression compression() const { return m_compression; }
+
+    // True if the input could not be read completely (e.g. corrupt gzip data)
+    bool failed() const;
+
+    // Get the next run of whole lines. The last chunk of a file may end
+    // without a newline. Returns false once the file is exhausted.
+    bool nextChunk(const char*& begin, const char*& end);
+
+    // Go back to the start of the file
+    void rewind();
+
+private:
+    // Read up to n bytes of (decompressed) text into dst
+    std::size_t fill(char* dst, std::size_t n);
+
+    std::string m_filename;
+    std::ifstream m_file;
+    Compression m_compression = Compression::None;
+    std::unique_ptr<DecompressionPipe> m_pipe;  // only used for compressed files
+    std::vector<char> m_buffer;
+    std::size_t m_filled = 0;    // bytes currently held in m_buffer
+    std::size_t m_consumed = 0;  // bytes already handed out by nextChunk
+    bool m_eof = false;
+};
+
+// Streams (x,y) points from a CSV file with a header line, like readDataFile
+class PointStream {
+public:
+    using Block = Points2D;
+
+    explicit PointStream(const std::string& filename, std::size_t blockSize = 4096);
+
+    bool isOpen() const { return m_reader.isOpen(); }
+    const std::string& filename() const { return m_filename; }
+    Compression compression() const { return m_reader.compression(); }
+    bool failed() const { return m_reader.failed(); }
+
+    // Replace the contents of block with up to blockSize points.
+    // Returns false once there are no more points.
+    bool next(Block& block);
+    void rewind();
+
+    // Input range over blocks
+    class iterator {
+    public:
+        using value_type = Block;
+        using difference_type = std::ptrdiff_t;
+        iterator() = default;
+        explicit iterator(PointStream* stream) : m_stream(stream) { ++(*this); }
+        const Block& operator*() const { return m_block; }
+        const Block* operator->() const { return &m_block; }
+        iterator& operator++() {
+            if (m_stream && !m_stream->next(m_block)) m_stream = nullptr;
+            return *this;
+        }
+        void operator++(int) { ++(*this); }
+        bool operator==(const iterator& other) const { return m_stream == other.m_stream; }
+    private:
+        PointStream* m_stream = nullptr;
+        Block m_block;
+    };
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    std::string m_filename;
+    ChunkReader m_reader;
+    std::size_t m_blockSize;
+    const char* m_pos = nullptr;  // unparsed text left in the current chunk
+    const char* m_end = nullptr;
+    bool m_headerPending = true;
+};
+
+// Streams whitespace-separated values, stopping at the first token that is
+// not a number (like a `file >> value` loop)
+class ValueStream {
+public:
+    using Block = std::vector<double>;
+
+    explicit ValueStream(const std::string& filename, std::size_t blockSize = 4096);
+
+    bool isOpen() const { return m_reader.isOpen(); }
+    const std::string& filename() const { return m_filename; }
+    Compression compression() const { return m_reader.compression(); }
+    bool failed() const { return m_reader.failed(); }
+
+    bool next(Block& block);
+    void rewind();
+
+    class iterator {
+    public:
+        using value_type = Block;
+        using difference_type = std::ptrdiff_t;
+        iterator() = default;
+        explicit iterator(ValueStream* stream) : m_stream(stream) { ++(*this); }
+        const Block& operator*() const { return m_block; }
+        const Block* operator->() const { return &m_block; }
+        iterator& operator++() {
+            if (m_stream && !m_stream->next(m_block)) m_stream = nullptr;
+            return *this;
+        }
+        void operator++(int) { ++(*this); }
+        bool operator==(const iterator& other) const { return m_stream == other.m_stream; }
+    private:
+        ValueStream* m_stream = nullptr;
+        Block m_block;
+    };
+    iterator begin() { return iterator(this); }
+    iterator end() { return iterator(); }
+
+private:
+    std::string m_filename;
+    ChunkReader m_reader;
+    std::size_t m_blockSize;
+    const char* m_pos = nullptr;
+    const char* m_end = nullptr;
+    bool m_stopped = false;  // hit a non-numeric token
+};
+
+#endif
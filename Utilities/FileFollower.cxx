@@ -0,0 +1,88 @@
+// FileFollower.cxx
+// Implementation of the incremental file reader
+// Date: October 2026
+
+#include "FileFollower.h"
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+// Most bytes read from the file at once
+constexpr std::size_t chunkSize = std::size_t(1) << 20;
+
+} // namespace
+
+FileFollower::FileFollower(const std::string& filename) : m_filename(filename) {
+    reopen();
+}
+
+FileFollower::~FileFollower() {
+    if (m_fd >= 0) ::close(m_fd);
+}
+
+bool FileFollower::reopen() {
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = ::open(m_filename.c_str(), O_RDONLY);
+    m_offset = 0;
+    m_partial.clear();
+    if (m_fd < 0) return false;
+
+    struct stat info;
+    if (::fstat(m_fd, &info) != 0) {
+        ::close(m_fd);
+        m_fd = -1;
+        return false;
+    }
+    m_inode = info.st_ino;
+    return true;
+}
+
+void FileFollower::restart() {
+    m_offset = 0;
+    m_partial.clear();
+}
+
+bool FileFollower::poll(std::string& lines) {
+    m_reset = false;
+
+    // Check the path rather than the descriptor, so a replaced file is noticed
+    struct stat info;
+    if (::stat(m_filename.c_str(), &info) != 0) return false;
+
+    if (m_fd < 0 || info.st_ino != m_inode) {
+        if (!reopen()) return false;
+        m_reset = true;
+    }
+    else if (static_cast<std::size_t>(info.st_size) < m_offset) {
+        // Truncated in place: whatever we had read no longer exists
+        restart();
+        m_reset = true;
+    }
+
+    if (static_cast<std::size_t>(info.st_size) == m_offset) return m_reset;
+
+    // Read only the new bytes, starting where the last poll stopped, in
+    // chunks so that a large append never needs one buffer of its full size
+    std::size_t end = static_cast<std::size_t>(info.st_size);
+    std::vector<char> buffer(std::min(chunkSize, end - m_offset));
+    bool gotLines = false;
+    while (m_offset < end) {
+        ssize_t n = ::pread(m_fd, buffer.data(), std::min(buffer.size(), end - m_offset),
+                            static_cast<off_t>(m_offset));
+        if (n <= 0) break;
+        m_offset += static_cast<std::size_t>(n);
+        m_partial.append(buffer.data(), static_cast<std::size_t>(n));
+
+        // Hand back complete lines only
+        std::size_t lastNewline = m_partial.rfind('\n');
+        if (lastNewline == std::string::npos) continue;
+        lines.append(m_partial, 0, lastNewline + 1);
+        m_partial.erase(0, lastNewline + 1);
+        gotLines = true;
+    }
+    return gotLines || m_reset;
+}
@@ -0,0 +1,53 @@
+// FileFollower.h
+// Incremental reader for text files that are still being appended to
+// Date: October 2026
+//
+// Like `tail -f`: each poll() hands back only the complete lines written since
+// the previous poll, so a growing file is never re-read from the start. A
+// partly written last line is held back until its newline arrives. If the
+// file is truncated or replaced (a different inode at the same path), the
+// follower starts again from the beginning and reports it through reset().
+
+#ifndef FILEFOLLOWER_H
+#define FILEFOLLOWER_H
+
+#include <string>
+#include <cstddef>
+#include <sys/types.h>
+
+class FileFollower {
+public:
+    explicit FileFollower(const std::string& filename);
+    ~FileFollower();
+
+    FileFollower(const FileFollower&) = delete;
+    FileFollower& operator=(const FileFollower&) = delete;
+
+    const std::string& filename() const { return m_filename; }
+
+    // Read everything appended since the last call. Complete lines are
+    // appended to lines (each ending in '\n'). Returns false if nothing new
+    // was available, including while the file does not exist yet.
+    bool poll(std::string& lines);
+
+    // Start reading from the beginning of the file again on the next poll()
+    void restart();
+
+    // True if the last poll() started again from the beginning of the file
+    bool reset() const { return m_reset; }
+
+    // Bytes of the file consumed so far
+    std::size_t offset() const { return m_offset; }
+
+private:
+    bool reopen();
+
+    std::string m_filename;
+    int m_fd = -1;
+    ino_t m_inode = 0;
+    std::size_t m_offset = 0;  // next byte to read
+    std::string m_partial;     // unterminated tail of the last read
+    bool m_reset = false;
+};
+
+#endif
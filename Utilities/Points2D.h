@@ -0,0 +1,131 @@
+// Points2D.h
+// Struct-of-arrays container for (x,y) data
+// Date: October 2026
+//
+// The x and y values are kept in two separate contiguous arrays, each aligned
+// to a 64-byte cache line, so per-column loops (sums, magnitudes, fits) read
+// memory linearly and vectorise cleanly.
+//
+// For compatibility with code written against std::vector<std::pair<double,double>>,
+// a Points2D converts implicitly to and from that type, and iterating over it
+// yields (x,y) pairs.
+
+#ifndef POINTS2D_H
+#define POINTS2D_H
+
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <new>
+#include <span>
+
+// Allocator returning memory aligned to Alignment bytes
+template <typename T, std::size_t Alignment = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+    }
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+};
+
+using AlignedVector = std::vector<double, AlignedAllocator<double>>;
+
+class Points2D {
+public:
+    Points2D() = default;
+
+    // Compatibility adaptor: build from the old array-of-pairs layout
+    Points2D(const std::vector<std::pair<double, double>>& points) {
+        reserve(points.size());
+        for (const auto& point : points) push_back(point.first, point.second);
+    }
+
+    // Compatibility adaptor: convert back to the old array-of-pairs layout
+    operator std::vector<std::pair<double, double>>() const {
+        std::vector<std::pair<double, double>> points;
+        points.reserve(size());
+        for (std::size_t i = 0; i < size(); i++) points.emplace_back(m_x[i], m_y[i]);
+        return points;
+    }
+
+    std::size_t size() const { return m_x.size(); }
+    bool empty() const { return m_x.empty(); }
+
+    void reserve(std::size_t n) {
+        m_x.reserve(n);
+        m_y.reserve(n);
+    }
+    void resize(std::size_t n) {
+        m_x.resize(n);
+        m_y.resize(n);
+    }
+    void clear() {
+        m_x.clear();
+        m_y.clear();
+    }
+
+    void push_back(double x, double y) {
+        m_x.push_back(x);
+        m_y.push_back(y);
+    }
+    void emplace_back(double x, double y) { push_back(x, y); }
+
+    // Append all points from other
+    void append(const Points2D& other) {
+        m_x.insert(m_x.end(), other.m_x.begin(), other.m_x.end());
+        m_y.insert(m_y.end(), other.m_y.begin(), other.m_y.end());
+    }
+
+    double x(std::size_t i) const { return m_x[i]; }
+    double y(std::size_t i) const { return m_y[i]; }
+    std::pair<double, double> operator[](std::size_t i) const { return {m_x[i], m_y[i]}; }
+
+    // Direct access to the aligned columns
+    const double* xData() const { return m_x.data(); }
+    const double* yData() const { return m_y.data(); }
+    double* xData() { return m_x.data(); }
+    double* yData() { return m_y.data(); }
+    std::span<const double> xs() const { return {m_x.data(), m_x.size()}; }
+    std::span<const double> ys() const { return {m_y.data(), m_y.size()}; }
+
+    bool operator==(const Points2D& other) const { return m_x == other.m_x && m_y == other.m_y; }
+
+    // Iterating yields (x,y) pairs by value, so `for (const auto& point : data)`
+    // loops written for the old layout still work
+    class const_iterator {
+    public:
+        using value_type = std::pair<double, double>;
+        using difference_type = std::ptrdiff_t;
+        const_iterator() = default;
+        const_iterator(const Points2D* points, std::size_t i) : m_points(points), m_i(i) {}
+        value_type operator*() const { return (*m_points)[m_i]; }
+        const_iterator& operator++() { m_i++; return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; m_i++; return old; }
+        bool operator==(const const_iterator& other) const { return m_i == other.m_i; }
+    private:
+        const Points2D* m_points = nullptr;
+        std::size_t m_i = 0;
+    };
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    AlignedVector m_x;
+    AlignedVector m_y;
+};
+
+#endif
@@ -0,0 +1,119 @@
+// ResultWriter.cxx
+// Implementation of the buffered result writer
+// Date: October 2026
+
+#include "ResultWriter.h"
+#include <charconv>
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+
+namespace {
+// Longest output of to_chars for a double (sign, 17 digits, point, exponent)
+const std::size_t MAX_NUMBER_CHARS = 32;
+
+// general + precision gives the same text as an ostream with setprecision
+std::to_chars_result formatDouble(char* first, char* last, double value, int precision) {
+    if (precision == SHORTEST_ROUND_TRIP) return std::to_chars(first, last, value);
+    return std::to_chars(first, last, value, std::chars_format::general, precision);
+}
+}
+
+ResultWriter::ResultWriter(const std::string& filename, std::size_t bufferBytes)
+    : m_file(filename, std::ios::binary | std::ios::trunc),
+      m_buffer(std::max(bufferBytes, MAX_NUMBER_CHARS)),
+      m_start(std::chrono::steady_clock::now()) {
+}
+
+ResultWriter::~ResultWriter() {
+    if (m_file.is_open()) close();
+}
+
+void ResultWriter::flush() {
+    if (m_used == 0) return;
+    m_file.write(m_buffer.data(), m_used);
+    if (!m_file) m_ok = false;
+    m_bytesWritten += m_used;
+    m_used = 0;
+}
+
+void ResultWriter::reserve(std::size_t n) {
+    if (m_buffer.size() - m_used < n) flush();
+}
+
+ResultWriter& ResultWriter::write(std::string_view text) {
+    // Text bigger than the whole buffer goes straight to the file
+    if (text.size() > m_buffer.size()) {
+        flush();
+        m_file.write(text.data(), text.size());
+        if (!m_file) m_ok = false;
+        m_bytesWritten += text.size();
+        return *this;
+    }
+    reserve(text.size());
+    std::memcpy(m_buffer.data() + m_used, text.data(), text.size());
+    m_used += text.size();
+    return *this;
+}
+
+ResultWriter& ResultWriter::write(double value) {
+    // With p significant digits the text is at most p digits plus the sign,
+    // point and exponent
+    std::size_t needed = MAX_NUMBER_CHARS + static_cast<std::size_t>(std::max(m_precision, 0));
+    if (needed > m_buffer.size()) {
+        // Only for precisions larger than the whole buffer: format on the side
+        std::vector<char> text(needed);
+        std::to_chars_result result = formatDouble(text.data(), text.data() + needed, value, m_precision);
+        if (result.ec != std::errc()) {
+            m_ok = false;
+            return *this;
+        }
+        return write(std::string_view(text.data(), result.ptr - text.data()));
+    }
+
+    reserve(needed);
+    char* first = m_buffer.data() + m_used;
+    std::to_chars_result result = formatDouble(first, first + needed, value, m_precision);
+    if (result.ec != std::errc()) {
+        m_ok = false; // nothing is committed, so close() reports the failure
+        return *this;
+    }
+    m_used += result.ptr - first;
+    return *this;
+}
+
+ResultWriter& ResultWriter::write(long long value) {
+    reserve(MAX_NUMBER_CHARS);
+    char* first = m_buffer.data() + m_used;
+    std::to_chars_result result = std::to_chars(first, first + MAX_NUMBER_CHARS, value);
+    if (result.ec != std::errc()) {
+        m_ok = false;
+        return *this;
+    }
+    m_used += result.ptr - first;
+    return *this;
+}
+
+ResultWriter& ResultWriter::newline() {
+    reserve(1);
+    m_buffer[m_used++] = '\n';
+    return *this;
+}
+
+bool ResultWriter::close() {
+    if (!m_file.is_open()) return false;
+    flush();
+    m_file.close();
+    if (m_file.fail()) m_ok = false;
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+    m_seconds = elapsed.count();
+    return m_ok;
+}
+
+std::string ResultWriter::summary() const {
+    double mbPerSecond = (m_seconds > 0.0) ? m_bytesWritten / m_seconds / 1.0e6 : 0.0;
+    std::ostringstream text;
+    text << m_bytesWritten << " bytes in " << m_seconds * 1000.0 << " ms (" << mbPerSecond << " MB/s)";
+    return text.str();
+}
@@ -0,0 +1,65 @@
+// ResultWriter.h
+// Buffered text writer for numeric results
+// Date: October 2026
+
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <fstream>
+#include <chrono>
+#include <cstddef>
+
+// Pass as the precision to write the shortest text that reads back to
+// exactly the same double
+const int SHORTEST_ROUND_TRIP = 0;
+
+// Formats numbers with std::to_chars into a large reusable buffer and only
+// touches the file when the buffer is full or the writer is closed, instead
+// of flushing on every line like std::endl does.
+class ResultWriter {
+public:
+    explicit ResultWriter(const std::string& filename, std::size_t bufferBytes = 1 << 20);
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    bool isOpen() const { return m_file.is_open(); }
+
+    // Significant digits for write(double), like std::setprecision (default 6).
+    // SHORTEST_ROUND_TRIP selects the exact round-trip form instead.
+    void setPrecision(int precision) { m_precision = precision; }
+
+    ResultWriter& write(std::string_view text);
+    ResultWriter& write(double value);
+    ResultWriter& write(long long value);
+    ResultWriter& newline();
+
+    // Flush the buffer and close the file. Returns false if anything failed
+    // to be written.
+    bool close();
+
+    std::size_t bytesWritten() const { return m_bytesWritten; }
+
+    // "N bytes in T ms (R MB/s)", valid after close()
+    std::string summary() const;
+
+private:
+    std::ofstream m_file;
+    std::vector<char> m_buffer;
+    std::size_t m_used = 0;
+    std::size_t m_bytesWritten = 0;
+    int m_precision = 6;
+    bool m_ok = true;
+    std::chrono::steady_clock::time_point m_start;
+    double m_seconds = 0.0;
+
+    void flush();
+    // Make sure at least n bytes are free in the buffer
+    void reserve(std::size_t n);
+};
+
+#endif
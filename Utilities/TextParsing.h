@@ -0,0 +1,79 @@
+// TextParsing.h
+// Allocation-free helpers for tokenising numeric text held in memory
+// Date: October 2026
+//
+// These are called once per token in the readers' inner loops, so they are
+// kept inline in the header.
+
+#ifndef TEXTPARSING_H
+#define TEXTPARSING_H
+
+#include <charconv>
+#include <cstring>
+#include <system_error>
+#include <vector>
+
+// True for the characters std::isspace accepts in the "C" locale
+inline bool isBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// Return a pointer to the next '\n' in [p, end), or end if there is none
+inline const char* findLineEnd(const char* p, const char* end) {
+    const void* found = std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+    return found ? static_cast<const char*>(found) : end;
+}
+
+// Return a pointer to the next occurrence of c in [p, end), or end
+inline const char* findChar(const char* p, const char* end, char c) {
+    const void* found = std::memchr(p, c, static_cast<std::size_t>(end - p));
+    return found ? static_cast<const char*>(found) : end;
+}
+
+// Parse a double starting at p, with the same leniency as std::stod:
+// leading whitespace and an explicit '+' sign are accepted and trailing
+// characters are ignored. On success p is advanced past the number.
+inline bool parseDouble(const char*& p, const char* end, double& value) {
+    const char* start = p;
+    while (start < end && isBlank(*start)) start++;
+    if (start + 1 < end && *start == '+' && start[1] != '-') start++;
+
+    auto [ptr, ec] = std::from_chars(start, end, value);
+    if (ec != std::errc()) return false;
+
+    p = ptr;
+    return true;
+}
+
+// Parse an "x,y" line in [line, lineEnd). Any further comma-separated fields
+// are ignored. Returns false for headers and malformed lines.
+inline bool parsePointLine(const char* line, const char* lineEnd, double& x, double& y) {
+    const char* comma = findChar(line, lineEnd, ',');
+    if (comma == lineEnd) return false;
+    const char* yEnd = findChar(comma + 1, lineEnd, ',');
+
+    const char* xPos = line;
+    const char* yPos = comma + 1;
+    return parseDouble(xPos, comma, x) && parseDouble(yPos, yEnd, y);
+}
+
+// Split [begin, end) into at most nChunks pieces of roughly equal size, with
+// every boundary placed just after a '\n' so no line straddles two chunks.
+// Returns the nChunks+1 (or fewer) boundary pointers, first = begin, last = end.
+inline std::vector<const char*> splitAtLineBoundaries(const char* begin, const char* end, int nChunks) {
+    std::vector<const char*> bounds{begin};
+    std::size_t total = static_cast<std::size_t>(end - begin);
+
+    for (int i = 1; i < nChunks; i++) {
+        const char* target = begin + total * i / nChunks;
+        if (target <= bounds.back()) continue; // previous line ran past this target
+        const char* cut = findLineEnd(target, end);
+        if (cut == end) break;
+        bounds.push_back(cut + 1);
+    }
+
+    if (bounds.back() != end) bounds.push_back(end);
+    return bounds;
+}
+
+#endif
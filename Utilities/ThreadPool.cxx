@@ -0,0 +1,42 @@
+// ThreadPool.cxx
+// Implementation of the worker thread pool
+// Date: October 2026
+
+#include "ThreadPool.h"
+#include <algorithm>
+
+int ThreadPool::workersFor(int nThreads) {
+    if (nThreads > 0) return nThreads;
+    return static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+}
+
+ThreadPool::ThreadPool(int nThreads) {
+    nThreads = workersFor(nThreads);
+    for (int i = 0; i < nThreads; i++) {
+        m_workers.emplace_back(&ThreadPool::workerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) worker.join();
+}
+
+void ThreadPool::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [this]() { return m_stopping || !m_tasks.empty(); });
+            // Drain the queue before honouring a stop request
+            if (m_tasks.empty()) return;
+            task = std::move(m_tasks.front());
+            m_tasks.pop();
+        }
+        task();
+    }
+}
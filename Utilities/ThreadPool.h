@@ -0,0 +1,60 @@
+// ThreadPool.h
+// Fixed-size pool of worker threads fed from a shared task queue
+// Date: October 2026
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <type_traits>
+
+// Runs submitted tasks on a bounded number of threads. submit() returns a
+// future for the task's result; the destructor finishes every queued task
+// before joining the workers.
+class ThreadPool {
+public:
+    // nThreads <= 0 uses one thread per hardware core
+    explicit ThreadPool(int nThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    int size() const { return static_cast<int>(m_workers.size()); }
+
+    // Number of workers ThreadPool(nThreads) would start, so a caller that
+    // would run everything inline on one thread can skip the pool
+    static int workersFor(int nThreads);
+
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task) {
+        using Result = std::invoke_result_t<F>;
+        // packaged_task is move-only, so share it to fit in a std::function
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_tasks.emplace([packaged]() { (*packaged)(); });
+        }
+        m_wake.notify_one();
+        return result;
+    }
+
+private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_tasks;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stopping = false;
+
+    void workerLoop();
+};
+
+#endif